@@ -0,0 +1,679 @@
+// bench/bench.cpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// Host benchmark of the render core. It builds from the portable sources in
+// src/ with the host compiler, renders a fixed set of named views at every
+// limit from 200 to 3200, and prints one CSV line per view and limit. Run it
+// with "make bench", or as "bench/wmcpp-bench [runs]".
+//
+// It also guards the exact counts. "record [DIR]" renders each view at its
+// verify limit and saves the field as a field file, the format the Wii's cache
+// uses, along with the fastest render time. "verify [DIR [tolerance
+// [slowdown%]]]" renders them again and fails on any pixel further than
+// tolerance from the recorded count, on a view slower than its recorded time by
+// more than the slowdown, or on a golden file that is missing. DIR defaults to
+// bench/golden, where the goldens are checked in
+//
+// Credited iterations are the sum of the counts, as on the debug strip, so a
+// pixel the cardioid test or the periodicity check settles counts in full.
+// Executed iterations are the ones the kernels actually ran, glitched
+// perturbation pixels included, and the rate and the time an iteration come
+// from those
+//
+// "check" runs the checks on code that has no golden field of its own, and
+// verify runs them too. One follows a deep zoom path and fails if the key it
+// zooms towards drifts from where a steady zoom puts it. Another renders views
+// at the spacing where the Wii turns to single precision and fails on any pixel
+// where the float field differs from the double one
+//
+// "field FILE" maps a field file from the Wii's cache in sd:/wmcpp-cache into
+// memory, decodes it where it lies and prints the view it holds, how well it
+// packed and how long decoding took
+
+#include "deepzoom.hpp"
+#include "field.hpp"
+#include "fieldfile.hpp"
+#include "kernel.hpp"
+#include "palettes.hpp"
+#include "render.hpp"
+#include "zoompath.hpp"
+
+#include <algorithm> // For std::max
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+  // The Wii's 640x480 framebuffer with the field below the 20 scanline strip
+  constexpr int SCREEN_W = 640;
+  constexpr int SCREEN_H = 480;
+  constexpr int FIELD_TOP = 20;
+  constexpr int SCREEN_W2 = SCREEN_W >> 1;
+  constexpr int SCREEN_H2 = SCREEN_H >> 1;
+
+  constexpr int DEFAULT_RUNS = 3;
+  constexpr int LIMIT_FIRST = 200;
+  constexpr int LIMIT_LAST = 3200;
+
+  // The arithmetic a view is timed in, matching the tiers the Wii picks from
+  enum class BenchKernel
+  {
+    Float,
+    Double,
+    DoubleDouble,
+    Perturbation
+  };
+
+  const char* const BenchKernelNames[] = {"float", "double", "dd", "pert"};
+
+  // A view centre is the sum of three doubles, which places it far closer than
+  // the deepest view here needs. Shallow views leave the last two at zero. The
+  // verify limit keeps the whole golden check to a few seconds
+  struct BenchView
+  {
+    const char* name;
+    BenchKernel kernel;
+    double centerRe[3];
+    double centerIm[3];
+    double zoom;
+    int verifyLimit;
+  };
+
+  // The double-double view sits on the Misiurewicz point i, where the
+  // filaments keep escaping within a few dozen iterations at any depth.
+  // The deep view is a period-50 minibrot on the filament running into the
+  // Misiurewicz point i, a copy of the set scaled down by about 1.8e-37. Its
+  // nucleus came from Newton's method at 100 digits, and the pixel spacing
+  // leaves it a quarter of the screen wide
+  const BenchView Views[] = {
+    {"start", BenchKernel::Double, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, 0.007, 800},
+    {"seahorse", BenchKernel::Double, {-0.743643887037151, 0.0, 0.0}, {0.131825904205330, 0.0, 0.0}, 1e-6, 800},
+    {"filament-dd", BenchKernel::DoubleDouble, {0.0, 0.0, 0.0}, {1.0, 0.0, 0.0}, 1e-15, 800},
+    {"minibrot", BenchKernel::Perturbation, {-5.52235468757652e-19, -4.5529724778942435e-35, -2.5899478466757403e-51},
+      {1.0, -4.553952868457216e-19, -1.4700365999571312e-35}, 4e-39, 800}};
+  constexpr int VIEW_COUNT = sizeof(Views) / sizeof(Views[0]);
+
+  // Each view's golden field is DIR/<name>.wfc, and DIR/times.txt holds a
+  // line of the view's name and its fastest render in milliseconds for each
+  constexpr const char* GOLDEN_DIR = "bench/golden";
+  constexpr const char* GOLDEN_TIMES = "times.txt";
+  constexpr int GOLDEN_PATH_SIZE = 256;
+
+  // Renders a view is timed over, keeping the fastest, which moves least with
+  // whatever else the host is doing
+  constexpr int GOLDEN_RUNS = 3;
+  constexpr int DEFAULT_SLOWDOWN_PERCENT = 15;
+
+  // Mismatched pixels listed per view before the rest are only counted
+  constexpr int MISMATCHES_LISTED = 8;
+
+  // The zoom path check goes from a key at this spacing to the minibrot view's
+  // centre, OFFSET pixels to its right, at the minibrot's spacing over FRAMES
+  // frames. Every frame has to put the minibrot within TOLERANCE pixels of
+  // where a steady zoom towards it does
+  constexpr double PATH_CHECK_SPACING = 1e-5;
+  constexpr double PATH_CHECK_OFFSET = 100.0;
+  constexpr int PATH_CHECK_FRAMES = 600;
+  constexpr double PATH_CHECK_TOLERANCE = 0.01;
+
+  // Centres the single precision check renders around, at the spacing where
+  // each turns to float. None sits on the boundary, where a pixel can land on
+  // either side of it in any precision
+  const double FloatCheckCenters[][2] = {
+    {0.0, 0.0}, {-0.75, 0.1}, {0.28, 0.01}, {-1.25, 0.0}, {-0.1, 0.9}, {-0.5, 0.0}, {-0.16, 1.04}};
+  constexpr int FLOAT_CHECK_COUNT = sizeof(FloatCheckCenters) / sizeof(FloatCheckCenters[0]);
+
+  FieldCount* field = nullptr;
+  FieldTile* fieldTiles = nullptr;
+  uint32_t* framebuffer = nullptr;
+
+  double elapsedMs(std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  /**
+   * Adds up the three doubles a view centre is given as, exactly
+   */
+  BigFixed viewCenter(const double parts[3])
+  {
+    const BigFixed low = BigFixedAdd(BigFixedFromDouble(parts[1]), BigFixedFromDouble(parts[2]));
+    return BigFixedAdd(BigFixedFromDouble(parts[0]), low);
+  }
+
+  /**
+   * Renders the whole field for one view in its kernel. There is no mirroring
+   * or progressive pass here, so every pixel is iterated exactly once
+   *
+   * @return Total iteration count across the field
+   */
+  uint64_t renderView(const BenchView& view, int limit)
+  {
+    const double centerRe = view.centerRe[0] + view.centerRe[1];
+    const double centerIm = view.centerIm[0] + view.centerIm[1];
+    uint64_t iterSum = 0;
+
+    if (view.kernel == BenchKernel::Perturbation)
+    {
+      DeepView deep;
+      deep.centerRe = viewCenter(view.centerRe);
+      deep.centerIm = viewCenter(view.centerIm);
+      deep.zoom = view.zoom;
+      deep.limit = limit;
+      deep.width = SCREEN_W;
+      deep.top = FIELD_TOP;
+      deep.height = SCREEN_H;
+      deep.centerCol = SCREEN_W2;
+      deep.centerRow = SCREEN_H2;
+      deep.cancel = nullptr;
+
+      DeepStats stats = {0, 0, 0, 0, 0};
+      if (!RenderDeepField(deep, field, stats))
+      {
+        fprintf(stderr, "Not enough memory for the reference orbit\n");
+        exit(1);
+      }
+      return stats.iterSum;
+    }
+
+    for (int h = FIELD_TOP; h < SCREEN_H; ++h)
+    {
+      FieldCount* rowField = field + (SCREEN_W * h);
+      const double rowOffset = -1.0 * (h - SCREEN_H2) * view.zoom;
+
+      if (view.kernel == BenchKernel::DoubleDouble)
+      {
+        const DoubleDouble ddCenterRe = ddQuickTwoSum(view.centerRe[0], view.centerRe[1]);
+        const DoubleDouble ci = ddAdd(ddQuickTwoSum(view.centerIm[0], view.centerIm[1]), {rowOffset, 0});
+        for (int w = 0; w < SCREEN_W; ++w)
+        {
+          const DoubleDouble cr = ddAdd(ddCenterRe, {(w - SCREEN_W2) * view.zoom, 0});
+          rowField[w] = static_cast<FieldCount>(computeMandelbrotIterationDD(cr, ci, limit));
+          iterSum += rowField[w];
+        }
+        continue;
+      }
+
+      iterSum += RenderRow(rowField, SCREEN_W, centerRe - SCREEN_W2 * view.zoom, view.zoom, centerIm + rowOffset, limit,
+        view.kernel == BenchKernel::Float);
+    }
+
+    return iterSum;
+  }
+
+  /**
+   * Times one view at one limit over runs renders and packs, and prints its
+   * CSV line. The pack time covers the tile summaries and the CPU pack stage,
+   * which is what a frame costs without GX
+   */
+  void benchView(const BenchView& view, int limit, int runs, PalettePtr palette)
+  {
+    const int pixels = SCREEN_W * (SCREEN_H - FIELD_TOP);
+    double renderSum = 0;
+    double renderSquares = 0;
+    double packSum = 0;
+    uint64_t credited = 0;
+    uint64_t executed = 0;
+
+    for (int run = 0; run < runs; ++run)
+    {
+      kernelExits = {0, 0, 0, 0, 0};
+      auto start = std::chrono::steady_clock::now();
+      credited = renderView(view, limit);
+      const double renderMs = elapsedMs(start);
+      executed = kernelExits.iterations;
+      renderSum += renderMs;
+      renderSquares += renderMs * renderMs;
+
+      start = std::chrono::steady_clock::now();
+      SummarizeField(field, SCREEN_W, FIELD_TOP, SCREEN_H, fieldTiles);
+      PackField(field, fieldTiles, framebuffer, SCREEN_W, FIELD_TOP, SCREEN_H, limit, run, palette);
+      packSum += elapsedMs(start);
+    }
+
+    const double renderMs = renderSum / runs;
+    const double variance = std::max(0.0, renderSquares / runs - renderMs * renderMs);
+
+    const double executedNs = (executed > 0) ? renderMs * 1e6 / executed : 0;
+    printf("%s,%s,%d,%d,%llu,%llu,%d,%.3f,%.3f,%.2f,%.3f,%.2f,%.2f\n", view.name,
+      BenchKernelNames[static_cast<int>(view.kernel)], limit, pixels, static_cast<unsigned long long>(credited),
+      static_cast<unsigned long long>(executed), runs, renderMs, std::sqrt(variance), executed / (renderMs * 1000.0),
+      executedNs, renderMs * 1e6 / pixels, (packSum / runs) * 1e6 / pixels);
+  }
+
+  /**
+   * Renders a view GOLDEN_RUNS times, leaving the field and its iteration total
+   * from the last one
+   *
+   * @return The fastest render time in milliseconds
+   */
+  double timeView(const BenchView& view, int limit, uint64_t& iterSum)
+  {
+    double fastest = 0;
+
+    for (int run = 0; run < GOLDEN_RUNS; ++run)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      iterSum = renderView(view, limit);
+      const double renderMs = elapsedMs(start);
+      fastest = (run == 0) ? renderMs : std::min(fastest, renderMs);
+    }
+
+    return fastest;
+  }
+
+  /**
+   * The view a bench view's field shows, as a field file names it. The frame
+   * loop's centreY runs down the screen, the opposite way to the imaginary axis
+   */
+  FieldFileView goldenView(const BenchView& view, uint64_t iterSum)
+  {
+    FieldFileView saved;
+    saved.centerX = viewCenter(view.centerRe);
+    saved.centerY = BigFixedNegate(viewCenter(view.centerIm));
+    saved.zoom = view.zoom;
+    saved.limit = view.verifyLimit;
+    saved.width = SCREEN_W;
+    saved.top = FIELD_TOP;
+    saved.height = SCREEN_H;
+    saved.iterSum = iterSum;
+    saved.iterPixels = SCREEN_W * (SCREEN_H - FIELD_TOP);
+    return saved;
+  }
+
+  int recordGolden(const char* dir, uint8_t* buffer)
+  {
+    char path[GOLDEN_PATH_SIZE];
+    snprintf(path, sizeof(path), "%s/%s", dir, GOLDEN_TIMES);
+    FILE* times = fopen(path, "w");
+    if (!times)
+    {
+      fprintf(stderr, "Cannot write %s\n", path);
+      return 1;
+    }
+
+    bool written = true;
+    for (int v = 0; v < VIEW_COUNT && written; ++v)
+    {
+      uint64_t iterSum;
+      const double renderMs = timeView(Views[v], Views[v].verifyLimit, iterSum);
+      const size_t size = FieldFileWrite(goldenView(Views[v], iterSum), field, buffer);
+
+      snprintf(path, sizeof(path), "%s/%s.wfc", dir, Views[v].name);
+      FILE* file = fopen(path, "wb");
+      written = file && fwrite(buffer, 1, size, file) == size;
+      written = (file && fclose(file) == 0) && written;
+      written = written && fprintf(times, "%s %.3f\n", Views[v].name, renderMs) > 0;
+      printf("%s: limit %d, %zu bytes, %.3f ms\n", Views[v].name, Views[v].verifyLimit, size, renderMs);
+    }
+
+    if (fclose(times) != 0 || !written)
+    {
+      fprintf(stderr, "Writing the goldens to %s failed\n", dir);
+      return 1;
+    }
+    return 0;
+  }
+
+  /**
+   * Reads the recorded render time of the view called name from DIR/times.txt
+   *
+   * @return False when the file or the view's line is missing
+   */
+  bool readGoldenTime(const char* dir, const char* name, double& renderMs)
+  {
+    char path[GOLDEN_PATH_SIZE];
+    snprintf(path, sizeof(path), "%s/%s", dir, GOLDEN_TIMES);
+    FILE* times = fopen(path, "r");
+    if (!times)
+    {
+      return false;
+    }
+
+    char line[GOLDEN_PATH_SIZE];
+    char viewName[GOLDEN_PATH_SIZE];
+    bool found = false;
+    while (!found && fgets(line, sizeof(line), times))
+    {
+      found = sscanf(line, "%255s %lf", viewName, &renderMs) == 2 && strcmp(viewName, name) == 0;
+    }
+
+    fclose(times);
+    return found;
+  }
+
+  /**
+   * Reads the golden field of view from dir into golden, which is a whole
+   * screen, through buffer, which holds the largest field file
+   *
+   * @return False when the file is missing or holds another view
+   */
+  bool readGoldenField(const char* dir, const BenchView& view, uint8_t* buffer, size_t bufferSize, FieldCount* golden)
+  {
+    char path[GOLDEN_PATH_SIZE];
+    snprintf(path, sizeof(path), "%s/%s.wfc", dir, view.name);
+    FILE* file = fopen(path, "rb");
+    if (!file)
+    {
+      return false;
+    }
+
+    const size_t size = fread(buffer, 1, bufferSize, file);
+    fclose(file);
+
+    FieldFileView saved;
+    const FieldFileView wanted = goldenView(view, 0);
+    return FieldFileReadView(buffer, size, saved) && FieldFileSameView(saved, wanted) && saved.limit == wanted.limit
+      && FieldFileReadField(buffer, size, saved, golden);
+  }
+
+  int verifyGolden(const char* dir, uint8_t* buffer, size_t bufferSize, FieldCount* golden, int tolerance,
+    int slowdownPercent)
+  {
+    const int pixels = SCREEN_W * (SCREEN_H - FIELD_TOP);
+    int failures = 0;
+
+    for (int v = 0; v < VIEW_COUNT; ++v)
+    {
+      const BenchView& view = Views[v];
+      double goldenMs;
+      if (!readGoldenField(dir, view, buffer, bufferSize, golden) || !readGoldenTime(dir, view.name, goldenMs))
+      {
+        printf("%s: FAIL, no golden field and time for it in %s\n", view.name, dir);
+        ++failures;
+        continue;
+      }
+
+      uint64_t iterSum;
+      const double renderMs = timeView(view, view.verifyLimit, iterSum);
+      const FieldCount* px = field + (SCREEN_W * FIELD_TOP);
+      const FieldCount* goldenPx = golden + (SCREEN_W * FIELD_TOP);
+      int mismatches = 0;
+      int worst = 0;
+
+      for (int i = 0; i < pixels; ++i)
+      {
+        const int diff = std::abs(px[i] - goldenPx[i]);
+        if (diff <= tolerance)
+        {
+          continue;
+        }
+
+        if (mismatches < MISMATCHES_LISTED)
+        {
+          printf("  %s (%d,%d): golden %d, now %d\n", view.name, i % SCREEN_W, FIELD_TOP + i / SCREEN_W, goldenPx[i],
+            px[i]);
+        }
+        worst = std::max(worst, diff);
+        ++mismatches;
+      }
+
+      const bool slow = renderMs > goldenMs * (100 + slowdownPercent) / 100.0;
+      printf("%s: %s, %d pixels off by up to %d, %.3f ms against %.3f ms%s\n", view.name,
+        (mismatches == 0 && !slow) ? "ok" : "FAIL", mismatches, worst, renderMs, goldenMs, slow ? " (slower)" : "");
+      failures += (mismatches != 0 || slow) ? 1 : 0;
+    }
+
+    return (failures == 0) ? 0 : 1;
+  }
+
+  /**
+   * Follows a zoom path from PATH_CHECK_SPACING down to the minibrot and
+   * measures, in each frame's own pixels, how far the minibrot's centre sits
+   * from where it belongs. The offset shrinks with the share of the zoom still
+   * to go, so it holds at PATH_CHECK_OFFSET until the spacing nears the end
+   *
+   * @return 0 when every frame was within PATH_CHECK_TOLERANCE
+   */
+  int checkZoomPath()
+  {
+    const BenchView& target = Views[VIEW_COUNT - 1];
+    ZoomPath path = {};
+    path.width = SCREEN_W;
+    path.height = SCREEN_H;
+    path.rate = 30;
+    path.keyCount = 2;
+    path.frameCount = PATH_CHECK_FRAMES + 1;
+
+    ZoomKey& from = path.keys[0];
+    ZoomKey& to = path.keys[1];
+    to.centerRe = viewCenter(target.centerRe);
+    to.centerIm = viewCenter(target.centerIm);
+    to.spacing = target.zoom;
+    to.limit = target.verifyLimit;
+    from.centerRe = BigFixedAdd(to.centerRe, BigFixedFromDouble(-PATH_CHECK_OFFSET * PATH_CHECK_SPACING));
+    from.centerIm = to.centerIm;
+    from.spacing = PATH_CHECK_SPACING;
+    from.limit = target.verifyLimit;
+    from.frames = PATH_CHECK_FRAMES;
+
+    double worst = 0;
+    int worstFrame = 0;
+    for (int f = 0; f <= PATH_CHECK_FRAMES; ++f)
+    {
+      PosterView view;
+      ZoomPathFrame(path, f, view);
+
+      const double share = (view.spacing - to.spacing) / (from.spacing - to.spacing);
+      const double expected = PATH_CHECK_OFFSET * (from.spacing / view.spacing) * share;
+      const double re = BigFixedToDouble(BigFixedAdd(to.centerRe, BigFixedNegate(view.centerRe))) / view.spacing;
+      const double im = BigFixedToDouble(BigFixedAdd(to.centerIm, BigFixedNegate(view.centerIm))) / view.spacing;
+      const double error = std::max(std::fabs(re - expected), std::fabs(im));
+      if (error > worst)
+      {
+        worst = error;
+        worstFrame = f;
+      }
+    }
+
+    const bool ok = worst <= PATH_CHECK_TOLERANCE;
+    printf("zoom path: %s, target off by up to %.3g pixels, at frame %d of %d\n", ok ? "ok" : "FAIL", worst,
+      worstFrame, PATH_CHECK_FRAMES);
+    return ok ? 0 : 1;
+  }
+
+  /**
+   * Renders each float check centre at the spacing where the Wii starts
+   * iterating it in single precision, in float and in double, at every limit,
+   * and fails on any pixel the two disagree on
+   */
+  int checkFloatTier()
+  {
+    FieldCount* single = field;
+    FieldCount* reference = field + SCREEN_W;
+    long long differing = 0;
+    long long pixels = 0;
+
+    for (int c = 0; c < FLOAT_CHECK_COUNT; ++c)
+    {
+      const double centerRe = FloatCheckCenters[c][0];
+      const double centerIm = FloatCheckCenters[c][1];
+      const double zoom = FLOAT_ZOOM_ULPS * FLT_EPSILON * precisionScale(centerRe, centerIm);
+      for (int limit = LIMIT_FIRST; limit <= LIMIT_LAST; limit <<= 1)
+      {
+        for (int h = FIELD_TOP; h < SCREEN_H; ++h)
+        {
+          const double ci = centerIm - (h - SCREEN_H2) * zoom;
+          const double rowStart = centerRe - SCREEN_W2 * zoom;
+          RenderRow(single, SCREEN_W, rowStart, zoom, ci, limit, true);
+          RenderRow(reference, SCREEN_W, rowStart, zoom, ci, limit, false);
+          for (int w = 0; w < SCREEN_W; ++w)
+          {
+            differing += (single[w] != reference[w]);
+          }
+          pixels += SCREEN_W;
+        }
+      }
+    }
+
+    printf("single precision: %s, %lld of %lld pixels differ from double\n", differing == 0 ? "ok" : "FAIL", differing,
+      pixels);
+    return differing == 0 ? 0 : 1;
+  }
+
+  int readFieldFile(const char* path)
+  {
+    const int fd = open(path, O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+      fprintf(stderr, "Cannot read %s\n", path);
+      if (fd >= 0)
+      {
+        close(fd);
+      }
+      return 1;
+    }
+
+    const size_t size = static_cast<size_t>(info.st_size);
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED)
+    {
+      fprintf(stderr, "Cannot map %s\n", path);
+      return 1;
+    }
+
+    const uint8_t* data = static_cast<const uint8_t*>(mapped);
+    FieldFileView view;
+    FieldCount* counts = nullptr;
+    int result = 1;
+
+    if (!FieldFileReadView(data, size, view))
+    {
+      fprintf(stderr, "%s is not a field file\n", path);
+    }
+    else if (!(counts = static_cast<FieldCount*>(malloc(sizeof(FieldCount) * view.width * view.height))))
+    {
+      fprintf(stderr, "Not enough memory for the field\n");
+    }
+    else
+    {
+      const auto start = std::chrono::steady_clock::now();
+      const bool decoded = FieldFileReadField(data, size, view, counts);
+      const double decodeMs = elapsedMs(start);
+
+      char centerX[BIGFIXED_TEXT_SIZE];
+      char centerY[BIGFIXED_TEXT_SIZE];
+      BigFixedToString(view.centerX, centerX);
+      BigFixedToString(BigFixedNegate(view.centerY), centerY);
+      const size_t raw = sizeof(FieldCount) * view.width * (view.height - view.top);
+
+      printf("re %s\nim %s\nspacing %.17g\nlimit %d\nfield %dx%d\n", centerX, centerY, view.zoom, view.limit,
+        view.width, view.height - view.top);
+      printf("%zu bytes, %.1f%% of the raw counts, decoded in %.3f ms\n", size, (100.0 * size) / raw, decodeMs);
+
+      if (decoded)
+      {
+        result = 0;
+      }
+      else
+      {
+        fprintf(stderr, "The counts do not fill the field\n");
+      }
+    }
+
+    free(counts);
+    munmap(mapped, size);
+    return result;
+  }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc > 2 && strcmp(argv[1], "field") == 0)
+  {
+    return readFieldFile(argv[2]);
+  }
+
+  const bool record = (argc > 1 && strcmp(argv[1], "record") == 0);
+  const bool verify = (argc > 1 && strcmp(argv[1], "verify") == 0);
+  const char* goldenDir = (argc > 2) ? argv[2] : GOLDEN_DIR;
+  const int runs = (argc > 1 && !record && !verify) ? std::max(1, atoi(argv[1])) : DEFAULT_RUNS;
+  const int tilesDown = (SCREEN_H - FIELD_TOP + FIELD_TILE - 1) / FIELD_TILE;
+
+  field = static_cast<FieldCount*>(malloc(sizeof(FieldCount) * SCREEN_W * SCREEN_H));
+  fieldTiles = static_cast<FieldTile*>(malloc(sizeof(FieldTile) * FieldTilesAcross(SCREEN_W) * tilesDown));
+  framebuffer = static_cast<uint32_t*>(malloc(sizeof(uint32_t) * (SCREEN_W >> 1) * SCREEN_H));
+
+  if (!field || !fieldTiles || !framebuffer)
+  {
+    fprintf(stderr, "Not enough memory for the field\n");
+    return 1;
+  }
+
+  if (argc > 1 && strcmp(argv[1], "check") == 0)
+  {
+    const int result = checkZoomPath() | checkFloatTier();
+    free(field);
+    free(fieldTiles);
+    free(framebuffer);
+    return result;
+  }
+
+  if (record || verify)
+  {
+    const FieldFileView screen = goldenView(Views[0], 0);
+    const size_t bufferSize = FieldFileBound(screen);
+    uint8_t* buffer = static_cast<uint8_t*>(malloc(bufferSize));
+    FieldCount* golden = static_cast<FieldCount*>(malloc(sizeof(FieldCount) * SCREEN_W * SCREEN_H));
+    int result = 1;
+
+    if (!buffer || !golden)
+    {
+      fprintf(stderr, "Not enough memory for the golden field\n");
+    }
+    else if (record)
+    {
+      result = recordGolden(goldenDir, buffer);
+    }
+    else
+    {
+      const int tolerance = (argc > 3) ? std::max(0, atoi(argv[3])) : 0;
+      const int slowdown = (argc > 4) ? std::max(0, atoi(argv[4])) : DEFAULT_SLOWDOWN_PERCENT;
+      result = verifyGolden(goldenDir, buffer, bufferSize, golden, tolerance, slowdown);
+      result |= checkZoomPath();
+      result |= checkFloatTier();
+    }
+
+    free(buffer);
+    free(golden);
+    free(field);
+    free(fieldTiles);
+    free(framebuffer);
+    return result;
+  }
+
+  printf("view,kernel,limit,pixels,credited_iterations,executed_iterations,runs,render_ms,render_stddev_ms,"
+    "miter_per_s,ns_per_iter,ns_per_pixel,pack_ns_per_pixel\n");
+  for (int v = 0; v < VIEW_COUNT; ++v)
+  {
+    for (int limit = LIMIT_FIRST; limit <= LIMIT_LAST; limit <<= 1)
+    {
+      benchView(Views[v], limit, runs, GetPalettePtr(0));
+    }
+  }
+
+  free(field);
+  free(fieldTiles);
+  free(framebuffer);
+  return 0;
+}
+
+// EOF
@@ -0,0 +1,120 @@
+// bench/poster.cpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// Host poster renderer. It runs the same band renderer the Wii uses, so a
+// poster started on the console can be finished faster on a PC from the
+// command line the console saves next to it. Build it with "make poster", and
+// run it as
+//
+//   bench/wmcpp-poster OUT WIDTH HEIGHT RE IM SPACING LIMIT PALETTE CYCLE
+//
+// RE and IM are decimal and exact to the last digit given, so the deepest
+// views carry over. OUT ending in .ppm writes a binary PPM, anything else a
+// PNG. Progress goes to stderr a line per band
+
+#include "deepzoom.hpp"
+#include "palettes.hpp"
+#include "poster.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+  constexpr int ARG_COUNT = 10;
+
+  double secondsSince(std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc != ARG_COUNT)
+  {
+    fprintf(stderr, "Usage: %s OUT WIDTH HEIGHT RE IM SPACING LIMIT PALETTE CYCLE\n", argv[0]);
+    return 1;
+  }
+
+  PosterView view;
+  view.width = atoi(argv[2]);
+  view.height = atoi(argv[3]);
+  view.spacing = strtod(argv[6], nullptr);
+  view.limit = atoi(argv[7]);
+  const int palette = atoi(argv[8]);
+  view.cycle = atoi(argv[9]) & 255;
+  view.cancel = nullptr;
+
+  if (!BigFixedFromString(argv[4], view.centerRe) || !BigFixedFromString(argv[5], view.centerIm))
+  {
+    fprintf(stderr, "The centre has to be two decimal numbers\n");
+    return 1;
+  }
+
+  if (view.spacing <= 0.0 || view.limit <= 0 || palette < 0 || palette >= GetPaletteCount())
+  {
+    fprintf(stderr, "Spacing and limit have to be positive, and the palette 0 to %d\n", GetPaletteCount() - 1);
+    return 1;
+  }
+  view.palette = GetPalettePtr(static_cast<uint8_t>(palette));
+
+  const size_t nameLength = strlen(argv[1]);
+  const bool ppm = nameLength > 4 && strcmp(argv[1] + nameLength - 4, ".ppm") == 0;
+  FILE* out = fopen(argv[1], "wb");
+  if (!out)
+  {
+    fprintf(stderr, "Could not create %s\n", argv[1]);
+    return 1;
+  }
+
+  PosterJob job;
+  if (!PosterBegin(job, view, out, ppm))
+  {
+    fprintf(stderr, "Could not start the poster. The width has to be even\n");
+    fclose(out);
+    return 1;
+  }
+
+  const int bands = (view.height + job.bandRows - 1) / job.bandRows;
+  const auto start = std::chrono::steady_clock::now();
+  bool written = true;
+
+  for (int band = 1; written && !PosterDone(job); ++band)
+  {
+    const auto bandStart = std::chrono::steady_clock::now();
+    const int firstRow = job.row;
+    written = PosterRenderBand(job);
+
+    const double bandSeconds = secondsSince(bandStart);
+    const double pixels = static_cast<double>(job.row - firstRow) * view.width;
+    const double elapsed = secondsSince(start);
+    const double remaining = elapsed * (view.height - job.row) / job.row;
+    fprintf(stderr, "Band %d/%d  %s  %.2f Mpx/s  ETA %.0f s\n", band, bands, job.deep ? "pert" : "double",
+      pixels / (bandSeconds * 1e6), remaining);
+  }
+
+  written = PosterFinish(job) && written;
+  written = (fclose(out) == 0) && written;
+
+  if (!written)
+  {
+    fprintf(stderr, "Could not write %s\n", argv[1]);
+    return 1;
+  }
+
+  fprintf(stderr, "Wrote %s in %.1f s\n", argv[1], secondsSince(start));
+  return 0;
+}
+
+// EOF
@@ -0,0 +1,203 @@
+// bench/zoompath.cpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// Host zoom path renderer. It reads the same path file the Wii reads from SD
+// and renders it with the same code, only faster. Build it with
+// "make zoompath", and run it as
+//
+//   bench/wmcpp-zoompath PATH OUT
+//
+// OUT ending in .y4m writes one YUV4MPEG2 stream, which ffmpeg and most
+// players take as it is. Any other OUT is a name pattern such as
+// frames/%05d.png, one PNG a frame, or PPM when it ends in .ppm. A second
+// thread renders each frame while the one before it is written, and progress
+// goes to stderr once a second of video
+
+#include "zoompath.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+  constexpr int ARG_COUNT = 3;
+  constexpr long MAX_PATH_BYTES = 64 * 1024;
+
+  double secondsSince(std::chrono::steady_clock::time_point start)
+  {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  bool endsWith(const char* text, const char* end)
+  {
+    const size_t length = strlen(text);
+    const size_t endLength = strlen(end);
+    return length >= endLength && strcmp(text + length - endLength, end) == 0;
+  }
+
+  // Reads the whole file into a string, or returns null
+  char* readText(const char* name)
+  {
+    FILE* in = fopen(name, "rb");
+    if (!in)
+    {
+      return nullptr;
+    }
+
+    char* text = static_cast<char*>(malloc(MAX_PATH_BYTES + 1));
+    const size_t length = text ? fread(text, 1, MAX_PATH_BYTES, in) : 0;
+    fclose(in);
+
+    if (text)
+    {
+      text[length] = '\0';
+    }
+    return text;
+  }
+
+  struct FrameJob
+  {
+    const ZoomPath* path;
+    int frame;
+    FieldCount* field;
+    PosterView view;
+    bool rendered;
+  };
+
+  void renderFrame(FrameJob* job)
+  {
+    ZoomPathFrame(*job->path, job->frame, job->view);
+    job->rendered = ZoomPathRender(job->view, job->field);
+  }
+}  // namespace
+
+int main(int argc, char** argv)
+{
+  if (argc != ARG_COUNT)
+  {
+    fprintf(stderr, "Usage: %s PATH OUT\n", argv[0]);
+    return 1;
+  }
+
+  char* text = readText(argv[1]);
+  if (!text)
+  {
+    fprintf(stderr, "Could not read %s\n", argv[1]);
+    return 1;
+  }
+
+  static ZoomPath path;
+  const int badLine = ZoomPathParse(text, path);
+  free(text);
+  if (badLine != 0)
+  {
+    fprintf(stderr, "%s:%d: expected size W H with W even, rate FPS or key RE IM SPACING LIMIT PALETTE FRAMES\n", argv[1],
+      badLine);
+    return 1;
+  }
+
+  ZoomPathWriter writer;
+  FILE* out = nullptr;
+  bool started;
+  if (endsWith(argv[2], ".y4m"))
+  {
+    out = fopen(argv[2], "wb");
+    started = out && ZoomPathBeginStream(writer, path, out);
+  }
+  else
+  {
+    started = strchr(argv[2], '%') && ZoomPathBeginImages(writer, path, argv[2], endsWith(argv[2], ".ppm"));
+  }
+
+  if (!started)
+  {
+    fprintf(stderr, "Could not start %s. Image names need a %%d for the frame\n", argv[2]);
+    if (out)
+    {
+      fclose(out);
+    }
+    return 1;
+  }
+
+  // Two frames in flight: one being written, the next being rendered
+  const size_t fieldBytes = sizeof(FieldCount) * path.width * path.height;
+  FrameJob jobs[2];
+  for (FrameJob& job : jobs)
+  {
+    job.path = &path;
+    job.field = static_cast<FieldCount*>(malloc(fieldBytes));
+    job.rendered = false;
+  }
+
+  if (!jobs[0].field || !jobs[1].field)
+  {
+    fprintf(stderr, "Could not allocate two %dx%d frames\n", path.width, path.height);
+    return 1;
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  jobs[0].frame = 0;
+  renderFrame(&jobs[0]);
+  bool written = jobs[0].rendered;
+
+  for (int frame = 0; written && frame < path.frameCount; ++frame)
+  {
+    FrameJob& current = jobs[frame & 1];
+    FrameJob& next = jobs[(frame + 1) & 1];
+
+    std::thread renderer;
+    if (frame + 1 < path.frameCount)
+    {
+      next.frame = frame + 1;
+      renderer = std::thread(renderFrame, &next);
+    }
+
+    written = ZoomPathWriteFrame(writer, current.view, current.field);
+
+    if (renderer.joinable())
+    {
+      renderer.join();
+      written = written && next.rendered;
+    }
+
+    if (((frame + 1) % path.rate) == 0 || frame + 1 == path.frameCount)
+    {
+      const double elapsed = secondsSince(start);
+      const double remaining = elapsed * (path.frameCount - frame - 1) / (frame + 1);
+      fprintf(stderr, "Frame %d/%d  %.2f fps  %.1f MB/s  ETA %.0f s\n", frame + 1, path.frameCount,
+        (frame + 1) / elapsed, writer.bytes / (elapsed * 1e6), remaining);
+    }
+  }
+
+  ZoomPathEnd(writer);
+  if (out)
+  {
+    written = (fclose(out) == 0) && written;
+  }
+  free(jobs[0].field);
+  free(jobs[1].field);
+
+  if (!written)
+  {
+    fprintf(stderr, "Could not render or write frame %d of %s\n", writer.frames, argv[2]);
+    return 1;
+  }
+
+  const double elapsed = secondsSince(start);
+  fprintf(stderr, "Wrote %d frames, %.1f MB, in %.1f s: %.2f fps, %.1f MB/s\n", writer.frames, writer.bytes / 1e6,
+    elapsed, writer.frames / elapsed, writer.bytes / (elapsed * 1e6));
+  return 0;
+}
+
+// EOF
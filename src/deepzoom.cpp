@@ -0,0 +1,555 @@
+// src/deepzoom.cpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#include "deepzoom.hpp"
+#include "kernel.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+namespace
+{
+  // A pixel whose orbit comes within this fraction of the reference's
+  // magnitude (squared here) has lost the bits that told it apart from the
+  // reference, and has to be redone against another one
+  constexpr double GLITCH_TOLERANCE = 1e-6;
+
+  // Each series term has to stay this far below the one before it for the
+  // truncated series to stand in for the iterations it skips
+  constexpr double SERIES_TOLERANCE = 1.0 / (1 << 20);
+
+  // References tried before the remaining glitched pixels are rebased onto
+  // the last one instead
+  constexpr int MAX_REFERENCES = 8;
+
+  // The reference orbit as doubles. Entry n is Z_n, and last is the final
+  // entry, which is either the limit or the iteration the reference escaped on
+  struct RefOrbit
+  {
+    double* re;
+    double* im;
+    // GLITCH_TOLERANCE times |Z_n|^2, worked out once per entry
+    double* tol;
+    int last;
+  };
+
+  // Truncated series for the offset after skip iterations, as a function of
+  // the pixel's offset dc: A dc + B dc^2 + C dc^3
+  struct Series
+  {
+    int skip;
+    double ar;
+    double ai;
+    double br;
+    double bi;
+    double cr;
+    double ci;
+  };
+
+  inline bool isNegative(const BigFixed& value)
+  {
+    return static_cast<int32_t>(value.word[BIGFIXED_WORDS - 1]) < 0;
+  }
+
+  inline double magnitude(double re, double im)
+  {
+    return std::sqrt(re * re + im * im);
+  }
+
+  /**
+   * Iterates the reference orbit at full precision and keeps each step as a
+   * double. Only the offsets from it need to be small, so the doubles lose
+   * nothing that matters
+   */
+  void computeReference(const BigFixed& cr, const BigFixed& ci, int limit, RefOrbit& ref)
+  {
+    BigFixed zr = BigFixedFromDouble(0.0);
+    BigFixed zi = zr;
+    ref.re[0] = 0;
+    ref.im[0] = 0;
+    ref.tol[0] = 0;
+
+    int n = 0;
+    while (n < limit)
+    {
+      const BigFixed zrSquared = BigFixedMul(zr, zr);
+      const BigFixed ziSquared = BigFixedMul(zi, zi);
+      const BigFixed zrzi = BigFixedMul(zr, zi);
+      zi = BigFixedAdd(BigFixedAdd(zrzi, zrzi), ci);
+      zr = BigFixedAdd(BigFixedAdd(zrSquared, BigFixedNegate(ziSquared)), cr);
+      ++n;
+
+      const double re = BigFixedToDouble(zr);
+      const double im = BigFixedToDouble(zi);
+      const double mag = re * re + im * im;
+      ref.re[n] = re;
+      ref.im[n] = im;
+      ref.tol[n] = GLITCH_TOLERANCE * mag;
+
+      if (mag >= 4)
+      {
+        break;
+      }
+    }
+
+    ref.last = n;
+  }
+
+  /**
+   * Finds how many iterations every pixel within radius of the reference can
+   * skip, by carrying a three term series along the reference orbit until the
+   * higher terms stop being negligible
+   */
+  Series computeSeries(const RefOrbit& ref, double radius)
+  {
+    Series s = {0, 0, 0, 0, 0, 0, 0};
+
+    // Stop one short of the end so each pixel still takes at least one step
+    for (int n = 0; n < ref.last - 1; ++n)
+    {
+      const double zr = ref.re[n];
+      const double zi = ref.im[n];
+
+      // A' = 2ZA + 1, B' = 2ZB + A^2, C' = 2ZC + 2AB
+      const double ar = 2.0 * (zr * s.ar - zi * s.ai) + 1.0;
+      const double ai = 2.0 * (zr * s.ai + zi * s.ar);
+      const double br = 2.0 * (zr * s.br - zi * s.bi) + (s.ar * s.ar - s.ai * s.ai);
+      const double bi = 2.0 * (zr * s.bi + zi * s.br) + 2.0 * s.ar * s.ai;
+      const double cr = 2.0 * (zr * s.cr - zi * s.ci) + 2.0 * (s.ar * s.br - s.ai * s.bi);
+      const double ci = 2.0 * (zr * s.ci + zi * s.cr) + 2.0 * (s.ar * s.bi + s.ai * s.br);
+
+      const double termA = magnitude(ar, ai) * radius;
+      const double termB = magnitude(br, bi) * radius * radius;
+      const double termC = magnitude(cr, ci) * radius * radius * radius;
+
+      // Written so that an overflow to infinity or NaN also stops the series
+      if (!(termB <= SERIES_TOLERANCE * termA) || !(termC <= SERIES_TOLERANCE * termB))
+      {
+        break;
+      }
+
+      s = {n + 1, ar, ai, br, bi, cr, ci};
+    }
+
+    return s;
+  }
+
+  /**
+   * Follows one pixel as an offset from the reference. Outside rebase mode a
+   * pixel that glitches stops with glitched set. In rebase mode it instead
+   * takes its full value as the offset and restarts from the front of the
+   * reference, which is always valid since Z_0 is zero
+   */
+  int perturbPixel(
+    const RefOrbit& ref, int limit, int start, double dzr, double dzi, double dcr, double dci,
+    bool rebase, bool& glitched)
+  {
+    int n = start;
+    int m = start;
+    glitched = false;
+
+    while (n < limit)
+    {
+      const double zr0 = ref.re[m];
+      const double zi0 = ref.im[m];
+
+      // dz' = 2 Z dz + dz^2 + dc
+      const double nextR = 2.0 * (zr0 * dzr - zi0 * dzi) + (dzr * dzr - dzi * dzi) + dcr;
+      const double nextI = 2.0 * (zr0 * dzi + zi0 * dzr) + 2.0 * dzr * dzi + dci;
+      dzr = nextR;
+      dzi = nextI;
+      ++n;
+      ++m;
+
+      const double zr = ref.re[m] + dzr;
+      const double zi = ref.im[m] + dzi;
+      const double mag = zr * zr + zi * zi;
+
+      if (mag >= 4)
+      {
+        return n;
+      }
+
+      if (rebase)
+      {
+        if (m == ref.last || mag < dzr * dzr + dzi * dzi)
+        {
+          dzr = zr;
+          dzi = zi;
+          m = 0;
+        }
+      }
+      else if (mag < ref.tol[m] || (m == ref.last && ref.last < limit))
+      {
+        // Running off the end of a reference that escaped leaves nothing to
+        // perturb against. The end of one that reached the limit is the limit
+        // for this pixel too, which is then interior
+        glitched = true;
+        return n;
+      }
+    }
+
+    return limit;
+  }
+
+  /**
+   * Renders every pixel of the view against one reference, or with onlyPending
+   * just the ones an earlier pass left pending
+   *
+   * @return Pixels left glitched, which this pass marks pending
+   */
+  uint32_t deepPass(
+    const DeepView& view, const RefOrbit& ref, const Series& series, int refCol, int refRow,
+    FieldCount* field, bool onlyPending, bool rebase, DeepStats& stats)
+  {
+    uint32_t pending = 0;
+
+    for (int y = view.top; y < view.height; ++y)
+    {
+      // Nothing is pending once cancelled, which ends the search for references
+      if (view.cancel && *view.cancel)
+      {
+        return 0;
+      }
+
+      FieldCount* rowField = field + (view.width * y);
+      const double dci = -(y - refRow) * view.zoom;
+
+      for (int x = 0; x < view.width; ++x)
+      {
+        if (onlyPending && rowField[x] != FIELD_PENDING)
+        {
+          continue;
+        }
+
+        const double dcr = (x - refCol) * view.zoom;
+
+        // dz = A dc + B dc^2 + C dc^3
+        const double dc2r = dcr * dcr - dci * dci;
+        const double dc2i = 2.0 * dcr * dci;
+        const double dc3r = dc2r * dcr - dc2i * dci;
+        const double dc3i = dc2r * dci + dc2i * dcr;
+        const double dzr = (series.ar * dcr - series.ai * dci) + (series.br * dc2r - series.bi * dc2i)
+          + (series.cr * dc3r - series.ci * dc3i);
+        const double dzi = (series.ar * dci + series.ai * dcr) + (series.br * dc2i + series.bi * dc2r)
+          + (series.cr * dc3i + series.ci * dc3r);
+
+        bool glitched;
+        const int n = perturbPixel(ref, view.limit, series.skip, dzr, dzi, dcr, dci, rebase, glitched);
+
+        // The series stood in for the iterations it skipped, and a glitched
+        // pixel ran its own before this reference gave out
+        kernelExits.iterations += static_cast<uint64_t>(n - series.skip);
+
+        if (glitched)
+        {
+          rowField[x] = FIELD_PENDING;
+          ++pending;
+          continue;
+        }
+
+        rowField[x] = static_cast<FieldCount>(n);
+        stats.iterSum += static_cast<uint64_t>(n);
+        ++stats.computed;
+
+        // Perturbation has neither the shortcut nor the periodicity check
+        if (n < view.limit)
+        {
+          ++kernelExits.escaped;
+        }
+        else
+        {
+          ++kernelExits.limit;
+        }
+      }
+    }
+
+    return pending;
+  }
+
+  /**
+   * Picks the next reference from among the glitched pixels: the one nearest
+   * their centroid, which usually lands inside the largest glitched patch
+   */
+  void pickReference(const DeepView& view, const FieldCount* field, int& refCol, int& refRow)
+  {
+    double sumX = 0;
+    double sumY = 0;
+    double count = 0;
+
+    for (int y = view.top; y < view.height; ++y)
+    {
+      const FieldCount* rowField = field + (view.width * y);
+      for (int x = 0; x < view.width; ++x)
+      {
+        if (rowField[x] == FIELD_PENDING)
+        {
+          sumX += x;
+          sumY += y;
+          count += 1;
+        }
+      }
+    }
+
+    const double meanX = sumX / count;
+    const double meanY = sumY / count;
+    double best = -1;
+
+    for (int y = view.top; y < view.height; ++y)
+    {
+      const FieldCount* rowField = field + (view.width * y);
+      for (int x = 0; x < view.width; ++x)
+      {
+        const double distance = (x - meanX) * (x - meanX) + (y - meanY) * (y - meanY);
+        if (rowField[x] == FIELD_PENDING && (best < 0 || distance < best))
+        {
+          best = distance;
+          refCol = x;
+          refRow = y;
+        }
+      }
+    }
+  }
+}  // namespace
+
+BigFixed BigFixedFromDouble(double value)
+{
+  BigFixed result;
+  const bool negative = value < 0;
+  const double mag = negative ? -value : value;
+  const double whole = std::floor(mag);
+  double frac = mag - whole;
+
+  result.word[BIGFIXED_WORDS - 1] = static_cast<uint32_t>(whole);
+  for (int i = BIGFIXED_WORDS - 2; i >= 0; --i)
+  {
+    // Scaling by a power of two and taking off the whole part are both exact
+    frac *= 4294967296.0;
+    const double digit = std::floor(frac);
+    result.word[i] = static_cast<uint32_t>(digit);
+    frac -= digit;
+  }
+
+  return negative ? BigFixedNegate(result) : result;
+}
+
+bool BigFixedFromString(const char* text, BigFixed& value)
+{
+  const bool negative = (*text == '-');
+  text += (*text == '-' || *text == '+') ? 1 : 0;
+
+  uint64_t whole = 0;
+  int wholeDigits = 0;
+  for (; *text >= '0' && *text <= '9'; ++text, ++wholeDigits)
+  {
+    whole = (whole * 10) + (*text - '0');
+    if (whole > 0x7FFFFFFF)
+    {
+      return false;
+    }
+  }
+
+  const char* fraction = text + ((*text == '.') ? 1 : 0);
+  int fractionDigits = 0;
+  for (text = fraction; *text >= '0' && *text <= '9'; ++text)
+  {
+    ++fractionDigits;
+  }
+
+  if (*text != '\0' || wholeDigits + fractionDigits == 0)
+  {
+    return false;
+  }
+
+  // The fraction is built from its last digit up, dividing by ten once a
+  // digit. A guard word below the last one keeps the truncations clear of
+  // the final rounding
+  uint32_t words[BIGFIXED_WORDS] = {};
+  for (int d = fractionDigits - 1; d >= 0; --d)
+  {
+    uint64_t rest = static_cast<uint64_t>(fraction[d] - '0');
+    for (int i = BIGFIXED_WORDS - 1; i >= 0; --i)
+    {
+      const uint64_t cur = (rest << 32) | words[i];
+      words[i] = static_cast<uint32_t>(cur / 10);
+      rest = cur % 10;
+    }
+  }
+
+  uint64_t carry = (words[0] >= 0x80000000u) ? 1 : 0;
+  for (int i = 0; i < BIGFIXED_WORDS - 1; ++i)
+  {
+    const uint64_t sum = static_cast<uint64_t>(words[i + 1]) + carry;
+    value.word[i] = static_cast<uint32_t>(sum);
+    carry = sum >> 32;
+  }
+  value.word[BIGFIXED_WORDS - 1] = static_cast<uint32_t>(whole + carry);
+
+  if (negative)
+  {
+    value = BigFixedNegate(value);
+  }
+  return true;
+}
+
+void BigFixedToString(const BigFixed& value, char* out)
+{
+  const bool negative = isNegative(value);
+  BigFixed mag = negative ? BigFixedNegate(value) : value;
+
+  out += sprintf(out, "%s%u.", negative ? "-" : "", static_cast<unsigned>(mag.word[BIGFIXED_WORDS - 1]));
+
+  // Each multiply by ten pushes the next digit out of the fraction's top
+  for (int d = 0; d < BIGFIXED_DIGITS; ++d)
+  {
+    uint64_t carry = 0;
+    for (int i = 0; i < BIGFIXED_WORDS - 1; ++i)
+    {
+      const uint64_t cur = (static_cast<uint64_t>(mag.word[i]) * 10) + carry;
+      mag.word[i] = static_cast<uint32_t>(cur);
+      carry = cur >> 32;
+    }
+    *out++ = static_cast<char>('0' + carry);
+  }
+  *out = '\0';
+}
+
+double BigFixedToDouble(const BigFixed& value)
+{
+  const bool negative = isNegative(value);
+  const BigFixed mag = negative ? BigFixedNegate(value) : value;
+  double result = 0;
+
+  for (int i = BIGFIXED_WORDS - 1; i >= 0; --i)
+  {
+    result += std::ldexp(static_cast<double>(mag.word[i]), 32 * (i - (BIGFIXED_WORDS - 1)));
+  }
+
+  return negative ? -result : result;
+}
+
+BigFixed BigFixedAdd(const BigFixed& a, const BigFixed& b)
+{
+  BigFixed result;
+  uint64_t carry = 0;
+
+  for (int i = 0; i < BIGFIXED_WORDS; ++i)
+  {
+    const uint64_t sum = static_cast<uint64_t>(a.word[i]) + b.word[i] + carry;
+    result.word[i] = static_cast<uint32_t>(sum);
+    carry = sum >> 32;
+  }
+
+  return result;
+}
+
+BigFixed BigFixedNegate(const BigFixed& value)
+{
+  BigFixed result;
+  uint64_t carry = 1;
+
+  for (int i = 0; i < BIGFIXED_WORDS; ++i)
+  {
+    const uint64_t sum = static_cast<uint64_t>(~value.word[i]) + carry;
+    result.word[i] = static_cast<uint32_t>(sum);
+    carry = sum >> 32;
+  }
+
+  return result;
+}
+
+BigFixed BigFixedMul(const BigFixed& a, const BigFixed& b)
+{
+  const bool negative = isNegative(a) != isNegative(b);
+  const BigFixed ma = isNegative(a) ? BigFixedNegate(a) : a;
+  const BigFixed mb = isNegative(b) ? BigFixedNegate(b) : b;
+
+  // Schoolbook product of the magnitudes. The binary point of the full
+  // product sits BIGFIXED_WORDS - 1 words higher than in either input
+  uint32_t product[BIGFIXED_WORDS * 2] = {};
+  for (int i = 0; i < BIGFIXED_WORDS; ++i)
+  {
+    uint64_t carry = 0;
+    for (int j = 0; j < BIGFIXED_WORDS; ++j)
+    {
+      const uint64_t cur = static_cast<uint64_t>(ma.word[i]) * mb.word[j] + product[i + j] + carry;
+      product[i + j] = static_cast<uint32_t>(cur);
+      carry = cur >> 32;
+    }
+    product[i + BIGFIXED_WORDS] = static_cast<uint32_t>(carry);
+  }
+
+  BigFixed result;
+  for (int k = 0; k < BIGFIXED_WORDS; ++k)
+  {
+    result.word[k] = product[k + BIGFIXED_WORDS - 1];
+  }
+
+  return negative ? BigFixedNegate(result) : result;
+}
+
+bool RenderDeepField(const DeepView& view, FieldCount* field, DeepStats& stats)
+{
+  const size_t entries = static_cast<size_t>(view.limit) + 1;
+  double* orbit = static_cast<double*>(malloc(sizeof(double) * entries * 3));
+
+  if (!orbit)
+  {
+    return false;
+  }
+
+  RefOrbit ref = {orbit, orbit + entries, orbit + (entries * 2), 0};
+  stats = {0, 0, 1, 0, 0};
+
+  // The first reference is the centre itself, which keeps every offset
+  // within half a screen and gives the series its best radius
+  computeReference(view.centerRe, view.centerIm, view.limit, ref);
+
+  const double halfW = view.width - view.centerCol;
+  const double halfH = view.height - view.centerRow;
+  const double radius = view.zoom * std::sqrt(halfW * halfW + halfH * halfH);
+  const Series series = computeSeries(ref, radius);
+  stats.seriesSkip = series.skip;
+
+  uint32_t pending = deepPass(view, ref, series, view.centerCol, view.centerRow, field, false, false, stats);
+
+  const Series none = {0, 0, 0, 0, 0, 0, 0};
+  int refCol = view.centerCol;
+  int refRow = view.centerRow;
+
+  while (pending > 0)
+  {
+    // Once the budget is spent the last reference takes what is left, with
+    // rebasing in place of detection so every pixel still finishes
+    const bool rebase = stats.references >= MAX_REFERENCES;
+
+    if (rebase)
+    {
+      stats.unresolved = pending;
+    }
+    else
+    {
+      pickReference(view, field, refCol, refRow);
+      const BigFixed re = BigFixedAdd(view.centerRe, BigFixedFromDouble((refCol - view.centerCol) * view.zoom));
+      const BigFixed im = BigFixedAdd(view.centerIm, BigFixedFromDouble(-(refRow - view.centerRow) * view.zoom));
+      computeReference(re, im, view.limit, ref);
+      ++stats.references;
+    }
+
+    pending = deepPass(view, ref, none, refCol, refRow, field, true, rebase, stats);
+  }
+
+  free(orbit);
+  return true;
+}
+
+// EOF
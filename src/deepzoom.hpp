@@ -0,0 +1,103 @@
+// src/deepzoom.hpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef DEEPZOOM_HPP
+#define DEEPZOOM_HPP
+
+#include "field.hpp"
+
+#include <cstdint>
+
+// Number of 32-bit words in a BigFixed. One holds the signed integer part and
+// the rest the fraction. That is 224 fraction bits, so the smallest step is
+// 2^-224, near 3.7e-68
+static constexpr int BIGFIXED_WORDS = 8;
+
+// A fixed point number in two's complement, least significant word first.
+// Doubles run out of bits for a view centre long before they run out of
+// exponent, so only the centre needs this; pixel spacing stays a double
+struct BigFixed
+{
+  uint32_t word[BIGFIXED_WORDS];
+};
+
+// Fraction digits BigFixedToString writes. A BigFixed's last step is near
+// 3.7e-68, and 70 digits cut short fall less than 1e-70 below the value, well
+// inside half a step, so the string reads back as exactly the same value
+static constexpr int BIGFIXED_DIGITS = 70;
+
+// Room for the sign, the integer part, the point, the digits and the end
+static constexpr int BIGFIXED_TEXT_SIZE = BIGFIXED_DIGITS + 16;
+
+// Converts exactly, as long as the value's bits fall inside the fraction
+BigFixed BigFixedFromDouble(double value);
+
+// Reads an optionally signed decimal such as -0.75 to the nearest step.
+// Returns false when text is not one, or its integer part does not fit
+bool BigFixedFromString(const char* text, BigFixed& value);
+
+// Writes value in decimal with BIGFIXED_DIGITS fraction digits. out needs
+// BIGFIXED_TEXT_SIZE characters
+void BigFixedToString(const BigFixed& value, char* out);
+
+// Rounds to the nearest double the top words can express
+double BigFixedToDouble(const BigFixed& value);
+
+BigFixed BigFixedAdd(const BigFixed& a, const BigFixed& b);
+BigFixed BigFixedNegate(const BigFixed& value);
+
+// Truncates the product to the same number of fraction bits
+BigFixed BigFixedMul(const BigFixed& a, const BigFixed& b);
+
+// The view the perturbation renderer draws. Columns and rows are field
+// coordinates, and the centre pixel sits exactly on the centre point
+struct DeepView
+{
+  BigFixed centerRe;
+  BigFixed centerIm;
+  double zoom;
+  int limit;
+  int width;
+  int top;
+  int height;
+  int centerCol;
+  int centerRow;
+  // Stops the render at the next row once set, leaving the field part drawn.
+  // Null when nothing will cancel it
+  const volatile bool* cancel;
+};
+
+// What a perturbation render did, for the debug strip
+struct DeepStats
+{
+  uint64_t iterSum;
+  uint32_t computed;
+  // Reference orbits computed, the first one included
+  int references;
+  // Iterations the series approximation let every pixel skip
+  int seriesSkip;
+  // Pixels still glitched when the reference budget ran out
+  uint32_t unresolved;
+};
+
+/**
+ * Renders rows top to height of a width-wide field by perturbation. One
+ * reference orbit is iterated at full precision, every pixel follows it as a
+ * double precision offset, and pixels that drift too close to the reference
+ * to trust are re-rendered against a new reference taken from among them.
+ *
+ * @return False when there was no memory for the reference orbit
+ */
+bool RenderDeepField(const DeepView& view, FieldCount* field, DeepStats& stats);
+
+#endif // DEEPZOOM_HPP
+
+// EOF
@@ -0,0 +1,156 @@
+// src/field.cpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#include "field.hpp"
+
+#include <algorithm> // For std::min, std::max
+#include <cstdlib> // For std::abs
+
+void SummarizeField(const FieldCount* field, int width, int top, int height, FieldTile* tiles)
+{
+  const int across = FieldTilesAcross(width);
+
+  for (int y0 = top; y0 < height; y0 += FIELD_TILE)
+  {
+    const int y1 = std::min(y0 + FIELD_TILE, height);
+
+    for (int tx = 0; tx < across; ++tx)
+    {
+      FieldTile tile = {FIELD_PENDING, 0};
+      tiles[tx] = tile;
+    }
+
+    // Rows are walked whole so the field streams through the cache in order,
+    // each row folding into the tiles it crosses
+    for (int y = y0; y < y1; ++y)
+    {
+      const FieldCount* rowField = field + (width * y);
+      for (int tx = 0; tx < across; ++tx)
+      {
+        const int x0 = tx * FIELD_TILE;
+        const int x1 = std::min(x0 + FIELD_TILE, width);
+        FieldCount low = tiles[tx].min;
+        FieldCount high = tiles[tx].max;
+
+        for (int x = x0; x < x1; ++x)
+        {
+          low = std::min(low, rowField[x]);
+          high = std::max(high, rowField[x]);
+        }
+
+        tiles[tx].min = low;
+        tiles[tx].max = high;
+      }
+    }
+
+    tiles += across;
+  }
+}
+
+/**
+ * Whether two neighbouring counts lie on either side of a boundary
+ */
+static inline bool isEdgeBetween(int n1, int n2, int limit)
+{
+  return (std::abs(n1 - n2) > EDGE_STEP) || ((n1 >= limit) != (n2 >= limit));
+}
+
+/**
+ * Whether the pixel at (x, y) differs from any of the four next to it
+ */
+static inline bool isEdgePixel(const FieldCount* field, int width, int top, int height, int limit, int x, int y)
+{
+  const FieldCount* pixel = field + (width * y) + x;
+  const int n = *pixel;
+
+  return (x > 0 && isEdgeBetween(n, pixel[-1], limit))
+    || (x + 1 < width && isEdgeBetween(n, pixel[1], limit))
+    || (y > top && isEdgeBetween(n, pixel[-width], limit))
+    || (y + 1 < height && isEdgeBetween(n, pixel[width], limit));
+}
+
+/**
+ * Whether a tile of a single count is surrounded by tiles of that same count,
+ * so that none of its pixels can be on a boundary
+ */
+static inline bool isFlatAmongFlat(const FieldTile* tile, int tx, int ty, int across, int down)
+{
+  const FieldCount n = tile->min;
+  const FieldTile* left = (tx > 0) ? tile - 1 : tile;
+  const FieldTile* right = (tx + 1 < across) ? tile + 1 : tile;
+  const FieldTile* up = (ty > 0) ? tile - across : tile;
+  const FieldTile* below = (ty + 1 < down) ? tile + across : tile;
+
+  return left->min == n && left->max == n && right->min == n && right->max == n
+    && up->min == n && up->max == n && below->min == n && below->max == n;
+}
+
+int FindFieldEdges(
+  const FieldCount* field,
+  const FieldTile* tiles,
+  int width,
+  int top,
+  int height,
+  int limit,
+  FieldEdge* edges,
+  int capacity)
+{
+  const int across = FieldTilesAcross(width);
+  const int down = (height - top + FIELD_TILE - 1) / FIELD_TILE;
+  int count = 0;
+
+  for (int ty = 0; ty < down; ++ty)
+  {
+    const int y0 = top + (ty * FIELD_TILE);
+    const int y1 = std::min(y0 + FIELD_TILE, height);
+
+    for (int tx = 0; tx < across; ++tx)
+    {
+      const FieldTile* tile = tiles + (ty * across) + tx;
+      const bool flat = (tile->min == tile->max);
+      if (flat && isFlatAmongFlat(tile, tx, ty, across, down))
+      {
+        continue;
+      }
+
+      const int x0 = tx * FIELD_TILE;
+      const int x1 = std::min(x0 + FIELD_TILE, width);
+      for (int y = y0; y < y1; ++y)
+      {
+        // Inside a tile of one count only the pixels along its sides have a
+        // neighbour that can differ
+        const bool side = (y == y0 || y == y1 - 1);
+        const int step = (flat && !side && x1 - x0 > 1) ? (x1 - 1 - x0) : 1;
+
+        for (int x = x0; x < x1; x += step)
+        {
+          if (!isEdgePixel(field, width, top, height, limit, x, y))
+          {
+            continue;
+          }
+
+          if (count == capacity)
+          {
+            return count;
+          }
+
+          edges[count].offset = static_cast<uint32_t>((width * y) + x);
+          edges[count].samples = 0;
+          ++count;
+        }
+      }
+    }
+  }
+
+  return count;
+}
+
+// EOF
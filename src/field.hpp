@@ -0,0 +1,89 @@
+// src/field.hpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef FIELD_HPP
+#define FIELD_HPP
+
+#include <cstdint>
+
+// The iteration field holds one count per pixel, row by row. No limit comes
+// near 16 bits, so a count takes two bytes and a full screen of them about
+// 600 KB, half what ints took, for every engine and both pack paths to stream
+typedef uint16_t FieldCount;
+
+// Marks a pixel nothing has computed yet
+static constexpr FieldCount FIELD_PENDING = 0xFFFF;
+
+// Side of the square tiles the field is summarised in
+static constexpr int FIELD_TILE = 16;
+
+// What one tile of the field holds. A tile whose min and max agree is a single
+// count, which the pack stages write without looking at its pixels. A tile all
+// inside the set is one of those, at the limit
+struct FieldTile
+{
+  FieldCount min;
+  FieldCount max;
+};
+
+// Tiles across a field width pixels wide, the last one cut short if need be.
+// Tile rows are counted the same way from the field's top row
+static inline int FieldTilesAcross(int width)
+{
+  return (width + FIELD_TILE - 1) / FIELD_TILE;
+}
+
+/**
+ * Summarises rows top to height of a width-wide field into tiles, starting at
+ * the top left and going a row of tiles at a time
+ */
+void SummarizeField(const FieldCount* field, int width, int top, int height, FieldTile* tiles);
+
+// Neighbours whose counts are further apart than this sit on a boundary. One
+// count is one step of the palette, which a smooth palette hardly shows
+static constexpr int EDGE_STEP = 2;
+
+// Most sub-pixel samples an edge pixel takes
+static constexpr int EDGE_SAMPLES = 8;
+
+// A pixel on a boundary, and the counts of the samples taken across it
+struct FieldEdge
+{
+  // Offset of the pixel in the field
+  uint32_t offset;
+  // How many of counts are in use, 0 until the pixel has been sampled
+  uint8_t samples;
+  FieldCount counts[EDGE_SAMPLES];
+};
+
+/**
+ * Lists the pixels of rows top to height that differ from a neighbour by more
+ * than EDGE_STEP, or where the set meets the outside, up to capacity of them.
+ * Tiles go in the order they are summarised and pixels row by row within one,
+ * so the two pixels of a framebuffer pair are always next to each other. A
+ * tile of a single count is only looked at along its sides, and not at all
+ * among neighbours of the same count
+ *
+ * @return Number of edges listed
+ */
+int FindFieldEdges(
+  const FieldCount* field,
+  const FieldTile* tiles,
+  int width,
+  int top,
+  int height,
+  int limit,
+  FieldEdge* edges,
+  int capacity);
+
+#endif // FIELD_HPP
+
+// EOF
@@ -0,0 +1,392 @@
+// src/fieldcache.cpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#include "fieldcache.hpp"
+#include "sdcard.hpp"
+
+#include <algorithm> // For std::max
+#include <cstdio>
+#include <cstdlib>
+#include <ogc/lwp_watchdog.h>
+#include <sys/stat.h>
+
+namespace
+{
+  constexpr u32 INDEX_MAGIC = 0x574D4349;
+  constexpr u32 INDEX_VERSION = 1;
+  const char* const CACHE_DIR = "sd:/wmcpp-cache";
+  const char* const INDEX_PATH = "sd:/wmcpp-cache/index.bin";
+
+  // One cached field. used is the index clock when it was last stored or
+  // loaded, and mark its place among the bookmarks, or -1
+  struct CacheEntry
+  {
+    u32 hash;
+    u32 limit;
+    u32 bytes;
+    u32 used;
+    s32 mark;
+  };
+
+  // Kept whole in memory and written whole to the card, which at a few
+  // kilobytes costs less than finding the part that changed
+  struct CacheIndex
+  {
+    u32 magic;
+    u32 version;
+    u32 clock;
+    s32 count;
+    CacheEntry entries[FIELD_CACHE_ENTRIES];
+  };
+
+  enum class CacheState
+  {
+    Closed,
+    Open,
+    NoCard
+  };
+
+  CacheIndex cacheIndex;
+  CacheState cacheState = CacheState::Closed;
+  FieldCacheStats stats = {0, 0, 0, 0, 0, 0, 0};
+
+  // A whole field file goes through here on its way to or from the card
+  uint8_t* buffer = nullptr;
+  size_t bufferSize = 0;
+
+  void countEntries()
+  {
+    stats.entries = cacheIndex.count;
+    stats.bytes = 0;
+    stats.marks = 0;
+    for (int i = 0; i < cacheIndex.count; ++i)
+    {
+      stats.bytes += cacheIndex.entries[i].bytes;
+      stats.marks += (cacheIndex.entries[i].mark >= 0) ? 1 : 0;
+    }
+  }
+
+  bool openCache()
+  {
+    if (cacheState != CacheState::Closed)
+    {
+      return cacheState == CacheState::Open;
+    }
+
+    cacheState = CacheState::NoCard;
+    if (!SDMount())
+    {
+      return false;
+    }
+
+    // Failing because it exists already is the usual case
+    mkdir(CACHE_DIR, 0777);
+
+    cacheIndex.magic = INDEX_MAGIC;
+    cacheIndex.version = INDEX_VERSION;
+    cacheIndex.clock = 0;
+    cacheIndex.count = 0;
+
+    static CacheIndex saved;
+    FILE* in = fopen(INDEX_PATH, "rb");
+    if (in)
+    {
+      if (fread(&saved, sizeof(saved), 1, in) == 1 && saved.magic == INDEX_MAGIC
+        && saved.version == INDEX_VERSION && saved.count >= 0 && saved.count <= FIELD_CACHE_ENTRIES)
+      {
+        cacheIndex = saved;
+      }
+      fclose(in);
+    }
+
+    countEntries();
+    cacheState = CacheState::Open;
+    return true;
+  }
+
+  void saveIndex()
+  {
+    FILE* out = fopen(INDEX_PATH, "wb");
+    if (out)
+    {
+      fwrite(&cacheIndex, sizeof(cacheIndex), 1, out);
+      fclose(out);
+    }
+  }
+
+  void entryPath(const CacheEntry& entry, char* path, size_t size)
+  {
+    snprintf(path, size, "%s/%08x-%u.wfc", CACHE_DIR, static_cast<unsigned>(entry.hash),
+      static_cast<unsigned>(entry.limit));
+  }
+
+  bool reserve(size_t bytes)
+  {
+    if (bufferSize < bytes)
+    {
+      free(buffer);
+      buffer = static_cast<uint8_t*>(malloc(bytes));
+      bufferSize = buffer ? bytes : 0;
+    }
+    return buffer != nullptr;
+  }
+
+  int findEntry(u32 hash, int limit)
+  {
+    for (int i = 0; i < cacheIndex.count; ++i)
+    {
+      if (cacheIndex.entries[i].hash == hash && static_cast<int>(cacheIndex.entries[i].limit) == limit)
+      {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  // Order does not matter, so the last entry fills the gap
+  void removeEntry(int i)
+  {
+    char path[48];
+    entryPath(cacheIndex.entries[i], path, sizeof(path));
+    remove(path);
+    cacheIndex.entries[i] = cacheIndex.entries[--cacheIndex.count];
+  }
+
+  /**
+   * Evicts the least recently used fields that are not bookmarks until one
+   * more of bytes fits
+   *
+   * @return False when bookmarks alone leave no room
+   */
+  bool makeRoom(u32 bytes)
+  {
+    while (cacheIndex.count > 0)
+    {
+      u32 total = 0;
+      int oldest = -1;
+      for (int i = 0; i < cacheIndex.count; ++i)
+      {
+        const CacheEntry& entry = cacheIndex.entries[i];
+        total += entry.bytes;
+        if (entry.mark < 0 && (oldest < 0 || entry.used < cacheIndex.entries[oldest].used))
+        {
+          oldest = i;
+        }
+      }
+
+      if (cacheIndex.count < FIELD_CACHE_ENTRIES && total + bytes <= FIELD_CACHE_BYTES)
+      {
+        return true;
+      }
+      if (oldest < 0)
+      {
+        return false;
+      }
+      removeEntry(oldest);
+    }
+
+    return bytes <= FIELD_CACHE_BYTES;
+  }
+
+  /**
+   * Reads an entry's file into the buffer, or its header only
+   *
+   * @return Bytes read, 0 when the file is missing or short
+   */
+  size_t readEntry(const CacheEntry& entry, bool headerOnly)
+  {
+    const size_t wanted = headerOnly ? FIELD_FILE_HEADER_BYTES : entry.bytes;
+    char path[48];
+    entryPath(entry, path, sizeof(path));
+
+    FILE* in = fopen(path, "rb");
+    if (!in)
+    {
+      return 0;
+    }
+
+    const bool read = reserve(wanted) && fread(buffer, 1, wanted, in) == wanted;
+    fclose(in);
+    return read ? wanted : 0;
+  }
+}  // namespace
+
+bool FieldCacheLoad(FieldFileView& view, bool anyLimit, FieldCount* field)
+{
+  if (!openCache())
+  {
+    return false;
+  }
+
+  const u64 start = gettime();
+  const u32 hash = FieldFileHash(view);
+  int found = -1;
+  for (int i = 0; i < cacheIndex.count; ++i)
+  {
+    const CacheEntry& entry = cacheIndex.entries[i];
+    if (entry.hash == hash && (anyLimit ? (found < 0 || entry.limit > cacheIndex.entries[found].limit)
+      : static_cast<int>(entry.limit) == view.limit))
+    {
+      found = i;
+    }
+  }
+
+  if (found < 0)
+  {
+    ++stats.misses;
+    return false;
+  }
+
+  // A hash shared with another view, or a file cut short, is dropped rather
+  // than trusted
+  FieldFileView saved;
+  const size_t size = readEntry(cacheIndex.entries[found], false);
+  if (size == 0 || !FieldFileReadView(buffer, size, saved) || !FieldFileSameView(saved, view)
+    || saved.limit != static_cast<int>(cacheIndex.entries[found].limit)
+    || !FieldFileReadField(buffer, size, saved, field))
+  {
+    removeEntry(found);
+    saveIndex();
+    countEntries();
+    ++stats.misses;
+    return false;
+  }
+
+  view.limit = saved.limit;
+  view.iterSum = saved.iterSum;
+  view.iterPixels = saved.iterPixels;
+
+  // The new order only goes to the card with the next store, so a hit costs
+  // no writing
+  cacheIndex.entries[found].used = ++cacheIndex.clock;
+  ++stats.hits;
+  stats.loadMicros = ticks_to_microsecs(gettime() - start);
+  return true;
+}
+
+bool FieldCacheStore(const FieldFileView& view, const FieldCount* field)
+{
+  if (!openCache() || !reserve(FieldFileBound(view)))
+  {
+    return false;
+  }
+
+  const u64 start = gettime();
+  const u32 bytes = static_cast<u32>(FieldFileWrite(view, field, buffer));
+  const u32 hash = FieldFileHash(view);
+
+  // Storing a view again keeps its bookmark
+  int slot = findEntry(hash, view.limit);
+  if (slot < 0)
+  {
+    if (!makeRoom(bytes))
+    {
+      return false;
+    }
+    slot = cacheIndex.count++;
+    cacheIndex.entries[slot].mark = -1;
+  }
+
+  CacheEntry& entry = cacheIndex.entries[slot];
+  entry.hash = hash;
+  entry.limit = static_cast<u32>(view.limit);
+  entry.bytes = bytes;
+  entry.used = ++cacheIndex.clock;
+
+  char path[48];
+  entryPath(entry, path, sizeof(path));
+  FILE* out = fopen(path, "wb");
+  bool written = out && fwrite(buffer, 1, bytes, out) == bytes;
+  written = out && (fclose(out) == 0) && written;
+
+  if (!written)
+  {
+    removeEntry(slot);
+  }
+  saveIndex();
+  countEntries();
+
+  stats.storeMicros = ticks_to_microsecs(gettime() - start);
+  return written;
+}
+
+bool FieldCacheMark(const FieldFileView& view)
+{
+  if (!openCache())
+  {
+    return false;
+  }
+
+  const int found = findEntry(FieldFileHash(view), view.limit);
+  if (found < 0)
+  {
+    return false;
+  }
+
+  if (cacheIndex.entries[found].mark >= 0)
+  {
+    return true;
+  }
+
+  int next = 0;
+  for (int i = 0; i < cacheIndex.count; ++i)
+  {
+    next = std::max(next, cacheIndex.entries[i].mark + 1);
+  }
+
+  if (stats.marks >= FIELD_CACHE_MARKS)
+  {
+    return false;
+  }
+
+  cacheIndex.entries[found].mark = next;
+  saveIndex();
+  countEntries();
+  return true;
+}
+
+bool FieldCacheMarkView(int mark, FieldFileView& view)
+{
+  if (!openCache() || mark < 0 || mark >= stats.marks)
+  {
+    return false;
+  }
+
+  // Marks keep the order they were made in, with gaps where one was dropped.
+  // The one wanted has exactly mark others below it
+  int found = -1;
+  for (int i = 0; i < cacheIndex.count && found < 0; ++i)
+  {
+    const s32 own = cacheIndex.entries[i].mark;
+    if (own < 0)
+    {
+      continue;
+    }
+
+    int below = 0;
+    for (int j = 0; j < cacheIndex.count; ++j)
+    {
+      below += (cacheIndex.entries[j].mark >= 0 && cacheIndex.entries[j].mark < own) ? 1 : 0;
+    }
+    found = (below == mark) ? i : -1;
+  }
+
+  // Only the header is read, so the size it is checked against is the file's
+  return found >= 0 && readEntry(cacheIndex.entries[found], true) != 0
+    && FieldFileReadView(buffer, cacheIndex.entries[found].bytes, view);
+}
+
+const FieldCacheStats& FieldCacheGetStats()
+{
+  return stats;
+}
+
+// EOF
@@ -0,0 +1,77 @@
+// src/fieldcache.hpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef FIELDCACHE_HPP
+#define FIELDCACHE_HPP
+
+#include "fieldfile.hpp"
+
+#include <gccore.h>
+
+// Finished fields kept on the SD card, so a view seen before loads in place
+// of rendering it again. Each view and limit gets a field file in
+// sd:/wmcpp-cache, and once they pass FIELD_CACHE_BYTES the least recently
+// used go. A bookmark is a cached field pinned so it is never evicted, which
+// is all it takes to go back to it. The card is mounted on first use, and a
+// missing card leaves the cache off until the next start
+
+static constexpr u32 FIELD_CACHE_BYTES = 16 << 20;
+static constexpr int FIELD_CACHE_ENTRIES = 256;
+static constexpr int FIELD_CACHE_MARKS = 16;
+
+// For the debug strip. The times are of the last hit to read and decode, and
+// of the last store to code and write
+struct FieldCacheStats
+{
+  int entries;
+  u32 bytes;
+  int marks;
+  u32 hits;
+  u32 misses;
+  u32 loadMicros;
+  u32 storeMicros;
+};
+
+/**
+ * Loads the cached field of view, at view.limit or with anyLimit at the
+ * highest limit cached, and fills in the limit and totals it was saved with
+ *
+ * @return False when it is not cached, or its file did not read back whole
+ */
+bool FieldCacheLoad(FieldFileView& view, bool anyLimit, FieldCount* field);
+
+/**
+ * Saves field as the view's, making room if need be
+ *
+ * @return False when there was no card, no room that bookmarks do not hold,
+ * or the file could not be written
+ */
+bool FieldCacheStore(const FieldFileView& view, const FieldCount* field);
+
+/**
+ * Bookmarks the cached field of view at view.limit
+ *
+ * @return False when it is not cached or every bookmark is taken
+ */
+bool FieldCacheMark(const FieldFileView& view);
+
+/**
+ * Reads the view of a bookmark, counting from 0 in the order they were made
+ *
+ * @return False when there is no such bookmark, or its file is unreadable
+ */
+bool FieldCacheMarkView(int mark, FieldFileView& view);
+
+const FieldCacheStats& FieldCacheGetStats();
+
+#endif // FIELDCACHE_HPP
+
+// EOF
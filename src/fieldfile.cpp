@@ -0,0 +1,258 @@
+// src/fieldfile.cpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#include "fieldfile.hpp"
+
+#include <cstring>
+
+namespace
+{
+  constexpr char FIELD_FILE_MAGIC[8] = {'W', 'M', 'C', 'P', 'F', 'L', 'D', '1'};
+  constexpr uint32_t FIELD_FILE_VERSION = 1;
+
+  // Tokens carry a flag in their low bit: set for a step to a new count, clear
+  // for a run repeating the last one
+  constexpr uint32_t TOKEN_STEP = 1;
+
+  inline uint8_t* put32(uint8_t* out, uint32_t value)
+  {
+    out[0] = static_cast<uint8_t>(value >> 24);
+    out[1] = static_cast<uint8_t>(value >> 16);
+    out[2] = static_cast<uint8_t>(value >> 8);
+    out[3] = static_cast<uint8_t>(value);
+    return out + 4;
+  }
+
+  inline uint8_t* put64(uint8_t* out, uint64_t value)
+  {
+    return put32(put32(out, static_cast<uint32_t>(value >> 32)), static_cast<uint32_t>(value));
+  }
+
+  inline uint32_t get32(const uint8_t*& in)
+  {
+    const uint32_t value = (static_cast<uint32_t>(in[0]) << 24) | (static_cast<uint32_t>(in[1]) << 16)
+      | (static_cast<uint32_t>(in[2]) << 8) | in[3];
+    in += 4;
+    return value;
+  }
+
+  inline uint64_t get64(const uint8_t*& in)
+  {
+    const uint64_t high = get32(in);
+    return (high << 32) | get32(in);
+  }
+
+  // Seven bits a byte, low first, the top bit set on all but the last
+  inline uint8_t* putToken(uint8_t* out, uint32_t token)
+  {
+    while (token >= 0x80)
+    {
+      *out++ = static_cast<uint8_t>(token | 0x80);
+      token >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(token);
+    return out;
+  }
+
+  inline bool getToken(const uint8_t*& in, const uint8_t* end, uint32_t& token)
+  {
+    token = 0;
+    for (int shift = 0; shift < 32 && in < end; shift += 7)
+    {
+      const uint8_t byte = *in++;
+      token |= static_cast<uint32_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+      {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  uint32_t mixHash(uint32_t hash, const void* data, size_t length)
+  {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < length; ++i)
+    {
+      hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+  }
+}  // namespace
+
+size_t FieldFileWrite(const FieldFileView& view, const FieldCount* field, uint8_t* out)
+{
+  uint8_t* const start = out;
+  uint8_t* const counts = out + FIELD_FILE_HEADER_BYTES;
+
+  // Steps are the difference from the last count, folded so small ones either
+  // way take small tokens
+  uint8_t* code = counts;
+  int last = 0;
+  uint32_t run = 0;
+  const FieldCount* px = field + (view.width * view.top);
+  const FieldCount* end = field + (view.width * view.height);
+  for (; px < end; ++px)
+  {
+    const int n = *px;
+    if (n == last)
+    {
+      ++run;
+      continue;
+    }
+
+    if (run > 0)
+    {
+      code = putToken(code, run << 1);
+      run = 0;
+    }
+
+    const int step = n - last;
+    const uint32_t folded = (step < 0) ? ((static_cast<uint32_t>(-step) << 1) - 1) : (static_cast<uint32_t>(step) << 1);
+    code = putToken(code, (folded << 1) | TOKEN_STEP);
+    last = n;
+  }
+
+  if (run > 0)
+  {
+    code = putToken(code, run << 1);
+  }
+
+  uint32_t xWords[BIGFIXED_WORDS];
+  uint32_t yWords[BIGFIXED_WORDS];
+  memcpy(xWords, view.centerX.word, sizeof(xWords));
+  memcpy(yWords, view.centerY.word, sizeof(yWords));
+  uint64_t zoomBits;
+  memcpy(&zoomBits, &view.zoom, sizeof(zoomBits));
+
+  memcpy(out, FIELD_FILE_MAGIC, sizeof(FIELD_FILE_MAGIC));
+  out += sizeof(FIELD_FILE_MAGIC);
+  out = put32(out, FIELD_FILE_VERSION);
+  out = put32(out, static_cast<uint32_t>(code - counts));
+  for (int i = 0; i < BIGFIXED_WORDS; ++i)
+  {
+    out = put32(out, xWords[i]);
+  }
+  for (int i = 0; i < BIGFIXED_WORDS; ++i)
+  {
+    out = put32(out, yWords[i]);
+  }
+  out = put64(out, zoomBits);
+  out = put32(out, static_cast<uint32_t>(view.limit));
+  out = put32(out, static_cast<uint32_t>(view.width));
+  out = put32(out, static_cast<uint32_t>(view.top));
+  out = put32(out, static_cast<uint32_t>(view.height));
+  out = put64(out, view.iterSum);
+  put32(out, view.iterPixels);
+
+  return static_cast<size_t>(code - start);
+}
+
+bool FieldFileReadView(const uint8_t* data, size_t size, FieldFileView& view)
+{
+  if (size < FIELD_FILE_HEADER_BYTES || memcmp(data, FIELD_FILE_MAGIC, sizeof(FIELD_FILE_MAGIC)) != 0)
+  {
+    return false;
+  }
+
+  const uint8_t* in = data + sizeof(FIELD_FILE_MAGIC);
+  const uint32_t version = get32(in);
+  const uint32_t countBytes = get32(in);
+  if (version != FIELD_FILE_VERSION || countBytes != size - FIELD_FILE_HEADER_BYTES)
+  {
+    return false;
+  }
+
+  for (int i = 0; i < BIGFIXED_WORDS; ++i)
+  {
+    view.centerX.word[i] = get32(in);
+  }
+  for (int i = 0; i < BIGFIXED_WORDS; ++i)
+  {
+    view.centerY.word[i] = get32(in);
+  }
+  const uint64_t zoomBits = get64(in);
+  memcpy(&view.zoom, &zoomBits, sizeof(view.zoom));
+  view.limit = static_cast<int>(get32(in));
+  view.width = static_cast<int>(get32(in));
+  view.top = static_cast<int>(get32(in));
+  view.height = static_cast<int>(get32(in));
+  view.iterSum = get64(in);
+  view.iterPixels = get32(in);
+
+  return view.limit > 0 && view.limit < FIELD_PENDING && view.width > 0
+    && view.top >= 0 && view.height > view.top && !(view.zoom <= 0.0);
+}
+
+bool FieldFileReadField(const uint8_t* data, size_t size, const FieldFileView& view, FieldCount* field)
+{
+  const uint8_t* in = data + FIELD_FILE_HEADER_BYTES;
+  const uint8_t* end = data + size;
+  FieldCount* px = field + (view.width * view.top);
+  FieldCount* const last = field + (view.width * view.height);
+  FieldCount n = 0;
+
+  while (in < end)
+  {
+    uint32_t token;
+    if (!getToken(in, end, token))
+    {
+      return false;
+    }
+
+    if (token & TOKEN_STEP)
+    {
+      const uint32_t folded = token >> 1;
+      const int step = (folded & 1) ? -static_cast<int>((folded + 1) >> 1) : static_cast<int>(folded >> 1);
+      const int next = n + step;
+      if (px == last || next < 0 || next > view.limit)
+      {
+        return false;
+      }
+      n = static_cast<FieldCount>(next);
+      *px++ = n;
+      continue;
+    }
+
+    const uint32_t run = token >> 1;
+    if (run == 0 || run > static_cast<uint32_t>(last - px))
+    {
+      return false;
+    }
+    for (uint32_t i = 0; i < run; ++i)
+    {
+      *px++ = n;
+    }
+  }
+
+  return px == last;
+}
+
+bool FieldFileSameView(const FieldFileView& a, const FieldFileView& b)
+{
+  return memcmp(&a.centerX, &b.centerX, sizeof(a.centerX)) == 0
+    && memcmp(&a.centerY, &b.centerY, sizeof(a.centerY)) == 0
+    && a.zoom == b.zoom && a.width == b.width && a.top == b.top && a.height == b.height;
+}
+
+uint32_t FieldFileHash(const FieldFileView& view)
+{
+  // FNV-1a over the same fields the comparison looks at
+  uint32_t hash = 2166136261u;
+  hash = mixHash(hash, view.centerX.word, sizeof(view.centerX.word));
+  hash = mixHash(hash, view.centerY.word, sizeof(view.centerY.word));
+  hash = mixHash(hash, &view.zoom, sizeof(view.zoom));
+  hash = mixHash(hash, &view.width, sizeof(view.width));
+  hash = mixHash(hash, &view.top, sizeof(view.top));
+  return mixHash(hash, &view.height, sizeof(view.height));
+}
+
+// EOF
@@ -0,0 +1,84 @@
+// src/fieldfile.hpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef FIELDFILE_HPP
+#define FIELDFILE_HPP
+
+// A finished field in a form worth keeping: a header naming the view it shows,
+// then its counts as runs of one count and the steps between them. Most of a
+// field is runs, and most steps fit a byte, so a screen of counts takes a
+// fraction of its 600 KB. The header is big endian and the counts a stream of
+// bytes, so a file the Wii writes reads the same on a PC, straight from memory
+
+#include "deepzoom.hpp"
+#include "field.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+// Header bytes ahead of the counts
+static constexpr size_t FIELD_FILE_HEADER_BYTES = 8 + (4 * 2) + (4 * BIGFIXED_WORDS * 2) + 8 + (4 * 4) + 8 + 4;
+
+// The view a field shows, as the frame loop holds it: centreY runs down the
+// screen, and the centre sits on field pixel (width / 2, height / 2). The
+// iteration totals go along for the debug strip
+struct FieldFileView
+{
+  BigFixed centerX;
+  BigFixed centerY;
+  double zoom;
+  int limit;
+  int width;
+  int top;
+  int height;
+  uint64_t iterSum;
+  uint32_t iterPixels;
+};
+
+// Most bytes a field file of view can take. A step takes three bytes at most,
+// and a run at least one pixel
+static inline size_t FieldFileBound(const FieldFileView& view)
+{
+  return FIELD_FILE_HEADER_BYTES + (3 * static_cast<size_t>(view.width) * (view.height - view.top));
+}
+
+/**
+ * Writes view and rows top to height of field to out, which needs
+ * FieldFileBound bytes
+ *
+ * @return Bytes written
+ */
+size_t FieldFileWrite(const FieldFileView& view, const FieldCount* field, uint8_t* out);
+
+/**
+ * Reads the header of the size bytes at data
+ *
+ * @return False when they are not a whole field file
+ */
+bool FieldFileReadView(const uint8_t* data, size_t size, FieldFileView& view);
+
+/**
+ * Decodes the counts of a file FieldFileReadView accepted into field, which
+ * has to be view.width wide and view.height tall
+ *
+ * @return False when the counts do not fill the rows exactly
+ */
+bool FieldFileReadField(const uint8_t* data, size_t size, const FieldFileView& view, FieldCount* field);
+
+// Whether two views show the same place at the same size, whatever the limit
+bool FieldFileSameView(const FieldFileView& a, const FieldFileView& b);
+
+// Hashes what FieldFileSameView compares
+uint32_t FieldFileHash(const FieldFileView& view);
+
+#endif // FIELDFILE_HPP
+
+// EOF
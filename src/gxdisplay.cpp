@@ -0,0 +1,424 @@
+// src/gxdisplay.cpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#include "gxdisplay.hpp"
+#include "render.hpp"
+
+#include <algorithm> // For std::min, std::max
+#include <cstdlib>
+#include <cstring>
+
+// Aligned buffer sizes for DMA transfers
+#define ALIGN32(x) (((x) + 31) & ~31)
+
+namespace
+{
+  constexpr u32 FIFO_SIZE = 256 * 1024;
+
+  // Escape counts take the first 256 entries and the interior the one after.
+  // Lookup tables come in multiples of 16 entries, so the 257 round up to 512
+  constexpr int INTERIOR_INDEX = 256;
+  constexpr int TLUT_ENTRIES = 512;
+
+  // CI14 texels are stored in 4x4 tiles
+  constexpr int TILE = 4;
+
+  void* fifo = nullptr;
+  u16* texels = nullptr;
+  u16* tlut = nullptr;
+  GXTexObj texObj;
+  GXTlutObj tlutObj;
+  GXRModeObj* rmode = nullptr;
+  int texWidth = 0;
+  int texHeight = 0;
+  int top = 0;
+  int screenW2 = 0;
+  int screenH2 = 0;
+  bool texDirty = true;
+  bool started = false;
+
+  // What the lookup table holds now, so an unchanged frame skips the upload
+  PalettePtr tlutPalette = nullptr;
+  int tlutCycle = -1;
+
+  // Each palette converted to the table's format once, when first shown
+  PalettePtr rgbPalette = nullptr;
+  u16 rgb[256];
+
+  // The edge overlay, an RGB5A3 texture the size of the field that a second
+  // stage lays over it. Texels off the edges stay clear. It is allocated the
+  // first time there are edges to show, and drawn while overlayShown says it
+  // holds the edges numbered overlaySerial in the lookup table's colours
+  u16* overlay = nullptr;
+  GXTexObj overlayObj;
+  u32 overlaySerial = 0;
+  int overlayCount = 0;
+  bool overlayShown = false;
+  PalettePtr overlayPalette = nullptr;
+  int overlayCycle = -1;
+
+  inline u8 clampChannel(int value)
+  {
+    return static_cast<u8>(std::min(255, std::max(0, value)));
+  }
+
+  /**
+   * Converts a palette entry to RGB. The palettes hold the YUV values the XFB
+   * used to get directly, and GX converts its RGB back with the BT.601 video
+   * range matrix on the way out, so this is that matrix inverted. Fixed point
+   * at 1/256 steps keeps floats out of it
+   */
+  void yuvToRgb(const uint8_t* yuv, u8& r, u8& g, u8& b)
+  {
+    const int y = 298 * (yuv[0] - 16);
+    const int u = yuv[1] - 128;
+    const int v = yuv[2] - 128;
+
+    r = clampChannel((y + 409 * v + 128) >> 8);
+    g = clampChannel((y - 100 * u - 208 * v + 128) >> 8);
+    b = clampChannel((y + 516 * u + 128) >> 8);
+  }
+
+  u16 yuvToRgb565(const uint8_t* yuv)
+  {
+    u8 r;
+    u8 g;
+    u8 b;
+    yuvToRgb(yuv, r, g, b);
+    return static_cast<u16>(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+  }
+
+  // An opaque RGB5A3 texel, which takes five bits a channel with the top bit set
+  u16 yuvToRgb5A3(const uint8_t* yuv)
+  {
+    u8 r;
+    u8 g;
+    u8 b;
+    yuvToRgb(yuv, r, g, b);
+    return static_cast<u16>(0x8000 | ((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3));
+  }
+
+  // Where texel (x, y) lives in a texture of 4x4 tiles
+  inline int tiledTexel(int x, int y)
+  {
+    return ((((y / TILE) * (texWidth / TILE)) + (x / TILE)) * (TILE * TILE)) + ((y % TILE) * TILE) + (x % TILE);
+  }
+
+  // Draws the field through whichever stages are on and copies the frame out
+  void drawField(u32* framebuffer, f32 centerCol, f32 centerRow, f32 scale)
+  {
+    if (texDirty)
+    {
+      GX_InvalidateTexAll();
+      texDirty = false;
+    }
+
+    GX_LoadTexObj(&texObj, GX_TEXMAP0);
+
+    const s16 left = 0;
+    const s16 right = static_cast<s16>(texWidth);
+    const s16 upper = static_cast<s16>(top);
+    const s16 lower = static_cast<s16>(top + texHeight);
+
+    // The field pixels under the quad's corners, as texture coordinates. Past
+    // the edges of the old field the clamp repeats its border
+    const f32 u0 = (centerCol + (left - screenW2) * scale) / texWidth;
+    const f32 u1 = (centerCol + (right - screenW2) * scale) / texWidth;
+    const f32 v0 = (centerRow + (upper - screenH2) * scale - top) / texHeight;
+    const f32 v1 = (centerRow + (lower - screenH2) * scale - top) / texHeight;
+
+    GX_Begin(GX_QUADS, GX_VTXFMT0, 4);
+    GX_Position2s16(left, upper);
+    GX_TexCoord2f32(u0, v0);
+    GX_Position2s16(right, upper);
+    GX_TexCoord2f32(u1, v0);
+    GX_Position2s16(right, lower);
+    GX_TexCoord2f32(u1, v1);
+    GX_Position2s16(left, lower);
+    GX_TexCoord2f32(u0, v1);
+    GX_End();
+
+    GX_CopyDisp(framebuffer, GX_TRUE);
+    GX_DrawDone();
+  }
+}  // namespace
+
+bool GXDisplayInit(GXRModeObj* mode, int screenW, int screenH, int fieldTop)
+{
+  rmode = mode;
+  top = fieldTop;
+  texWidth = screenW;
+  texHeight = screenH - fieldTop;
+  screenW2 = screenW >> 1;
+  screenH2 = screenH >> 1;
+
+  // The texture unit reads whole tiles, so the field has to fill them
+  if ((texWidth % TILE) != 0 || (texHeight % TILE) != 0)
+  {
+    return false;
+  }
+
+  fifo = aligned_alloc(32, FIFO_SIZE);
+  texels = static_cast<u16*>(aligned_alloc(32, ALIGN32(sizeof(u16) * texWidth * texHeight)));
+  tlut = static_cast<u16*>(aligned_alloc(32, ALIGN32(sizeof(u16) * TLUT_ENTRIES)));
+
+  if (!fifo || !texels || !tlut)
+  {
+    GXDisplayShutdown();
+    return false;
+  }
+
+  memset(fifo, 0, FIFO_SIZE);
+  memset(tlut, 0, sizeof(u16) * TLUT_ENTRIES);
+  GX_Init(fifo, FIFO_SIZE);
+  started = true;
+
+  GXColor background = {0, 0, 0, 0xff};
+  GX_SetCopyClear(background, GX_MAX_Z24);
+
+  GX_SetViewport(0, 0, rmode->fbWidth, rmode->efbHeight, 0, 1);
+  const f32 yScale = GX_GetYScaleFactor(rmode->efbHeight, rmode->xfbHeight);
+  const u32 xfbHeight = GX_SetDispCopyYScale(yScale);
+  GX_SetScissor(0, 0, rmode->fbWidth, rmode->efbHeight);
+  GX_SetDispCopySrc(0, 0, rmode->fbWidth, rmode->efbHeight);
+  GX_SetDispCopyDst(rmode->fbWidth, xfbHeight);
+  GX_SetCopyFilter(rmode->aa, rmode->sample_pattern, GX_TRUE, rmode->vfilter);
+  GX_SetFieldMode(rmode->field_rendering, (rmode->viHeight == 2 * rmode->xfbHeight) ? GX_ENABLE : GX_DISABLE);
+  GX_SetPixelFmt(GX_PF_RGB8_Z24, GX_ZC_LINEAR);
+  GX_SetDispCopyGamma(GX_GM_1_0);
+  GX_SetCullMode(GX_CULL_NONE);
+  GX_SetClipMode(GX_CLIP_DISABLE);
+  GX_SetZMode(GX_FALSE, GX_ALWAYS, GX_FALSE);
+  GX_SetBlendMode(GX_BM_NONE, GX_BL_ONE, GX_BL_ZERO, GX_LO_CLEAR);
+  GX_SetColorUpdate(GX_TRUE);
+
+  // Screen space positions and 0..1 texture coordinates, nothing else
+  GX_ClearVtxDesc();
+  GX_SetVtxDesc(GX_VA_POS, GX_DIRECT);
+  GX_SetVtxDesc(GX_VA_TEX0, GX_DIRECT);
+  GX_SetVtxAttrFmt(GX_VTXFMT0, GX_VA_POS, GX_POS_XY, GX_S16, 0);
+  GX_SetVtxAttrFmt(GX_VTXFMT0, GX_VA_TEX0, GX_TEX_ST, GX_F32, 0);
+
+  Mtx44 projection;
+  guOrtho(projection, 0, rmode->efbHeight, 0, rmode->fbWidth, 0, 1);
+  GX_LoadProjectionMtx(projection, GX_ORTHOGRAPHIC);
+
+  Mtx identity;
+  guMtxIdentity(identity);
+  GX_LoadPosMtxImm(identity, GX_PNMTX0);
+
+  // One stage that passes the looked up colour straight through
+  GX_SetNumChans(1);
+  GX_SetNumTexGens(1);
+  GX_SetTexCoordGen(GX_TEXCOORD0, GX_TG_MTX2x4, GX_TG_TEX0, GX_IDENTITY);
+  GX_SetNumTevStages(1);
+  GX_SetTevOrder(GX_TEVSTAGE0, GX_TEXCOORD0, GX_TEXMAP0, GX_COLOR0A0);
+  GX_SetTevOp(GX_TEVSTAGE0, GX_REPLACE);
+
+  // A second stage mixes the edge overlay in by its alpha, which is all or
+  // nothing. It only runs while there are edges to show
+  GX_SetTevOrder(GX_TEVSTAGE1, GX_TEXCOORD0, GX_TEXMAP1, GX_COLORNULL);
+  GX_SetTevColorIn(GX_TEVSTAGE1, GX_CC_CPREV, GX_CC_TEXC, GX_CC_TEXA, GX_CC_ZERO);
+  GX_SetTevAlphaIn(GX_TEVSTAGE1, GX_CA_ZERO, GX_CA_ZERO, GX_CA_ZERO, GX_CA_APREV);
+  GX_SetTevColorOp(GX_TEVSTAGE1, GX_TEV_ADD, GX_TB_ZERO, GX_CS_SCALE_1, GX_TRUE, GX_TEVPREV);
+  GX_SetTevAlphaOp(GX_TEVSTAGE1, GX_TEV_ADD, GX_TB_ZERO, GX_CS_SCALE_1, GX_TRUE, GX_TEVPREV);
+
+  // Indices cannot be blended, so the texture samples nearest only
+  GX_InitTexObjCI(&texObj, texels, texWidth, texHeight, GX_TF_CI14, GX_CLAMP, GX_CLAMP, GX_FALSE, GX_BIGTLUT0);
+  GX_InitTexObjLOD(&texObj, GX_NEAR, GX_NEAR, 0, 0, 0, GX_FALSE, GX_FALSE, GX_ANISO_1);
+  GX_InitTlutObj(&tlutObj, tlut, GX_TL_RGB565, TLUT_ENTRIES);
+
+  tlutPalette = nullptr;
+  tlutCycle = -1;
+  rgbPalette = nullptr;
+  overlayCount = 0;
+  overlayShown = false;
+  texDirty = true;
+  return true;
+}
+
+void GXDisplayUploadField(const FieldCount* field, const FieldTile* tiles, int limit)
+{
+  u16* dst = texels;
+  const int across = FieldTilesAcross(texWidth);
+
+  for (int y = 0; y < texHeight; y += TILE)
+  {
+    const FieldCount* tileRow = field + (texWidth * (top + y));
+    const FieldTile* rowTiles = tiles + ((y / FIELD_TILE) * across);
+    for (int x = 0; x < texWidth; x += TILE)
+    {
+      // A field tile of one count covers whole texel tiles, which then take a
+      // single index without reading the field
+      const FieldTile& summary = rowTiles[x / FIELD_TILE];
+      if (summary.min == summary.max)
+      {
+        const int n = summary.min;
+        const u16 index = static_cast<u16>((n == limit) ? INTERIOR_INDEX : (n & 255));
+        for (int i = 0; i < TILE * TILE; ++i)
+        {
+          *dst++ = index;
+        }
+        continue;
+      }
+
+      for (int r = 0; r < TILE; ++r)
+      {
+        const FieldCount* src = tileRow + (texWidth * r) + x;
+        for (int c = 0; c < TILE; ++c)
+        {
+          const int n = src[c];
+          *dst++ = static_cast<u16>((n == limit) ? INTERIOR_INDEX : (n & 255));
+        }
+      }
+    }
+  }
+
+  DCFlushRange(texels, ALIGN32(sizeof(u16) * texWidth * texHeight));
+  texDirty = true;
+}
+
+void GXDisplaySetPalette(PalettePtr palette, int cycle)
+{
+  cycle &= 255;
+
+  if (palette == tlutPalette && cycle == tlutCycle)
+  {
+    return;
+  }
+
+  if (palette != rgbPalette)
+  {
+    for (int i = 0; i < 256; ++i)
+    {
+      rgb[i] = yuvToRgb565(palette[i]);
+    }
+    rgbPalette = palette;
+  }
+
+  // Rotating the table is the whole cost of a cycling step
+  for (int i = 0; i < 256; ++i)
+  {
+    tlut[i] = rgb[(i + cycle) & 255];
+  }
+  tlut[INTERIOR_INDEX] = 0;
+
+  DCFlushRange(tlut, ALIGN32(sizeof(u16) * TLUT_ENTRIES));
+  GX_LoadTlut(&tlutObj, GX_BIGTLUT0);
+
+  tlutPalette = palette;
+  tlutCycle = cycle;
+
+  // The overlay's colours are the old table's until the edges come again
+  overlayShown = false;
+}
+
+void GXDisplaySetEdges(const FieldEdge* edges, int count, int limit, u32 serial, bool cycling)
+{
+  // Every cycling step moves the table on, and blending the edges again for
+  // each would bring back the per-pixel cost the table saves
+  if (cycling)
+  {
+    overlayShown = false;
+    return;
+  }
+
+  const bool sameEdges = (serial == overlaySerial && count == overlayCount);
+  if (sameEdges && (count == 0 || overlayShown))
+  {
+    return;
+  }
+
+  // New edges are somewhere else, so the old ones are cleared first. The same
+  // edges in new colours land on the same texels
+  const u32 bytes = ALIGN32(sizeof(u16) * texWidth * texHeight);
+  if (!sameEdges && overlayCount > 0)
+  {
+    memset(overlay, 0, bytes);
+  }
+  overlaySerial = serial;
+  overlayCount = 0;
+  overlayShown = false;
+
+  if (count == 0)
+  {
+    return;
+  }
+
+  if (!overlay)
+  {
+    overlay = static_cast<u16*>(aligned_alloc(32, bytes));
+    if (!overlay)
+    {
+      return;
+    }
+    memset(overlay, 0, bytes);
+    GX_InitTexObj(&overlayObj, overlay, texWidth, texHeight, GX_TF_RGB5A3, GX_CLAMP, GX_CLAMP, GX_FALSE);
+    GX_InitTexObjLOD(&overlayObj, GX_NEAR, GX_NEAR, 0, 0, 0, GX_FALSE, GX_FALSE, GX_ANISO_1);
+  }
+
+  for (int i = 0; i < count; ++i)
+  {
+    const int x = static_cast<int>(edges[i].offset % texWidth);
+    const int y = static_cast<int>(edges[i].offset / texWidth) - top;
+    uint8_t yuv[3];
+    BlendFieldEdge(edges[i], limit, tlutCycle, tlutPalette, yuv);
+    overlay[tiledTexel(x, y)] = yuvToRgb5A3(yuv);
+  }
+
+  DCFlushRange(overlay, bytes);
+  texDirty = true;
+  overlayCount = count;
+  overlayShown = true;
+}
+
+void GXDisplayDraw(u32* framebuffer)
+{
+  if (overlayShown)
+  {
+    GX_SetNumTevStages(2);
+    GX_LoadTexObj(&overlayObj, GX_TEXMAP1);
+  }
+  else
+  {
+    GX_SetNumTevStages(1);
+  }
+
+  drawField(framebuffer, screenW2, screenH2, 1.0f);
+}
+
+void GXDisplayDrawPreview(u32* framebuffer, f32 centerCol, f32 centerRow, f32 scale)
+{
+  // Edges belong to the field at its own scale
+  GX_SetNumTevStages(1);
+  drawField(framebuffer, centerCol, centerRow, scale);
+}
+
+void GXDisplayShutdown()
+{
+  // Stop the GPU before its FIFO goes back to the heap
+  if (started)
+  {
+    GX_AbortFrame();
+    started = false;
+  }
+
+  free(fifo);
+  fifo = nullptr;
+  free(texels);
+  texels = nullptr;
+  free(tlut);
+  tlut = nullptr;
+  free(overlay);
+  overlay = nullptr;
+}
+
+// EOF
@@ -0,0 +1,63 @@
+// src/gxdisplay.hpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef GXDISPLAY_HPP
+#define GXDISPLAY_HPP
+
+#include "field.hpp"
+#include "palettes.hpp"
+
+#include <gccore.h>
+
+// Draws the iteration field with the GPU. The field goes up once per change
+// as a colour-index texture, the palette goes up as a lookup table, and the
+// texture unit does the lookup while GX copies the frame out to the XFB. The
+// palette rotation and the black interior live in the table, so cycling and
+// switching palettes never touch a field pixel on the CPU. The antialiased
+// edges are blended on the CPU instead, so they stay off while the palette
+// cycles and are blended once for each palette it stops on
+
+// Sets up GX and the texture for a field screenW wide, covering rows fieldTop
+// to screenH. Returns false when the FIFO or texture could not be allocated
+bool GXDisplayInit(GXRModeObj* mode, int screenW, int screenH, int fieldTop);
+
+// Converts the field into the texture's index layout, filling tiles the
+// summaries show to be a single count without reading them. Only needed when
+// the counts change, or the limit that decides which of them are interior
+void GXDisplayUploadField(const FieldCount* field, const FieldTile* tiles, int limit);
+
+// Loads palette rotated by cycle into the lookup table. Does nothing if the
+// table already holds that palette at that rotation
+void GXDisplaySetPalette(PalettePtr palette, int cycle);
+
+// Shows count sampled edges over the field from the next draw, each blended
+// from its samples in the colours of the palette last set. serial tells one
+// list of edges from the next, and the overlay is only written again when it
+// or the palette changed. A palette change hides the overlay until then, and
+// so does cycling, which leaves it hidden until cycling is off. A count of 0
+// takes it away
+void GXDisplaySetEdges(const FieldEdge* edges, int count, int limit, u32 serial, bool cycling);
+
+// Draws the field with any edges over it and copies the frame into
+// framebuffer, returning once the copy has landed so text and the cursor can
+// be drawn over it
+void GXDisplayDraw(u32* framebuffer);
+
+// Draws the field scaled, as a stand-in for a view that is still rendering.
+// The screen centre shows field pixel (centerCol, centerRow), and each screen
+// pixel spans scale field pixels
+void GXDisplayDrawPreview(u32* framebuffer, f32 centerCol, f32 centerRow, f32 scale);
+
+void GXDisplayShutdown();
+
+#endif // GXDISPLAY_HPP
+
+// EOF
@@ -0,0 +1,443 @@
+// src/kernel.hpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+// Portions Copyright (C) 2011 Krupkat <krupkat@seznam.cz>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef KERNEL_HPP
+#define KERNEL_HPP
+
+// The escape-time kernels. Nothing in here touches libogc, so the same code
+// builds for the Wii and for a Linux host, where the pair kernel can be checked
+// against the scalar one without a console in the loop
+
+#include <algorithm> // For std::min, std::max
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+
+/**
+ * How pixels left the kernels since the counts were last cleared, for the
+ * debug strip. Each pixel bumps one of them on its way out, never inside the
+ * orbit loop, and a pair kernel counts both of its lanes. It adds the
+ * iterations it ran on the way out as well
+ */
+struct KernelExits
+{
+  // Settled by the cardioid or period-2 bulb test without iterating
+  uint32_t shortcut;
+  // Caught repeating an earlier point by the periodicity check
+  uint32_t periodic;
+  uint32_t escaped;
+  // Ran all the way to the limit
+  uint32_t limit;
+  // Iterations actually run. A count is credited in full when the shortcut or
+  // the periodicity check settles a pixel, so this falls short of their sum
+  uint64_t iterations;
+};
+
+inline KernelExits kernelExits = {0, 0, 0, 0, 0};
+
+// While the pixel spacing is at least this many float epsilons of the view's
+// scale, rows iterate in single precision. The orbit magnifies a float
+// coordinate's rounding, so any view that shows the boundary in detail lands on
+// other counts at a few of its pixels, the start view included. By this
+// spacing the whole set spans a few pixels, and the float and double fields of
+// views around it match, which the bench checks
+static constexpr double FLOAT_ZOOM_ULPS = 4194304.0;
+
+/**
+ * The magnitude a view's pixel spacing is measured against when choosing its
+ * precision. Pixels further from the origin sit between more widely spaced
+ * numbers, and |c| past 2 has escaped anyway, so the scale stops there
+ */
+static inline double precisionScale(double centerX, double centerY)
+{
+  return std::min(2.0, std::max({1.0, std::fabs(centerX), std::fabs(centerY)}));
+}
+
+// Pre-computed constants for cardioid/bulb check
+static constexpr double CARD_P1 = 0.25;
+static constexpr double CARD_P2 = 0.0625;
+
+/**
+ * Checks if a point is inside the main Cardioid or the period-2 Bulb.
+ * Extracted to reduce cyclomatic complexity of the main compute function.
+ */
+static inline bool isInsideCardioidOrBulb(double cr, double ciSquared)
+{
+  // q = (x - 1/4)^2 + y^2
+  double q = (cr - CARD_P1) * (cr - CARD_P1) + ciSquared;
+
+  // Cardioid: q * (q + (x - 1/4)) <= 1/4 * y^2
+  if (q * (q + (cr - CARD_P1)) <= CARD_P1 * ciSquared)
+  {
+    return true;
+  }
+  // Period-2 Bulb: (x + 1)^2 + y^2 <= 1/16
+  if (((cr + 1.0) * (cr + 1.0) + ciSquared) <= CARD_P2)
+  {
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * One point's orbit together with where its periodicity check stands. The pair
+ * kernel retires one lane and finishes the other in the scalar loop, so the
+ * check has to travel with the orbit or the two kernels would disagree on the
+ * points it catches. Real is double, or float for the shallow fast path
+ */
+template <typename Real>
+struct OrbitLane
+{
+  Real zr;
+  Real zi;
+  Real zrSquared;
+  Real ziSquared;
+  Real checkZr;
+  Real checkZi;
+  int n;
+  int count;
+  int updateInterval;
+  bool periodic;
+};
+
+template <typename Real>
+static inline void startLane(OrbitLane<Real>& lane)
+{
+  lane.zr = 0;
+  lane.zi = 0;
+  lane.zrSquared = 0;
+  lane.ziSquared = 0;
+  lane.checkZr = 0;
+  lane.checkZi = 0;
+  lane.n = 0;
+  lane.count = 0;
+  lane.updateInterval = 1;
+  lane.periodic = false;
+}
+
+/**
+ * Advances a lane by one iteration. A lane caught repeating itself belongs to
+ * the set, so it leaves with its count set to the limit
+ *
+ * @return True while the lane has neither escaped nor reached the limit
+ */
+template <typename Real>
+static inline bool stepLane(OrbitLane<Real>& lane, Real cr, Real ci, int localLimit)
+{
+  lane.zi = (lane.zr + lane.zr) * lane.zi + ci;
+  lane.zr = lane.zrSquared - lane.ziSquared + cr;
+  lane.zrSquared = lane.zr * lane.zr;
+  lane.ziSquared = lane.zi * lane.zi;
+  ++lane.n;
+
+  if (lane.zr == lane.checkZr && lane.zi == lane.checkZi)
+  {
+    kernelExits.iterations += static_cast<uint64_t>(lane.n);
+    lane.n = localLimit;
+    lane.periodic = true;
+    return false;
+  }
+
+  if (++lane.count >= lane.updateInterval)
+  {
+    lane.checkZr = lane.zr;
+    lane.checkZi = lane.zi;
+    lane.count = 0;
+    lane.updateInterval <<= 1;
+    if (lane.updateInterval > 128)
+    {
+      lane.updateInterval = 128;
+    }
+  }
+
+  return lane.zrSquared + lane.ziSquared < 4 && lane.n != localLimit;
+}
+
+/**
+ * Counts how a finished lane left the loop
+ */
+template <typename Real>
+static inline void countExit(const OrbitLane<Real>& lane, int localLimit)
+{
+  if (lane.periodic)
+  {
+    // Its iterations were counted when the check caught it
+    ++kernelExits.periodic;
+    return;
+  }
+
+  kernelExits.iterations += static_cast<uint64_t>(lane.n);
+  if (lane.n < localLimit)
+  {
+    ++kernelExits.escaped;
+  }
+  else
+  {
+    ++kernelExits.limit;
+  }
+}
+
+/**
+ * Computes the iteration count for a single Mandelbrot pixel. The coordinates
+ * always arrive as doubles and the shortcut test stays in double; only the
+ * orbit runs in Real
+ */
+template <typename Real = double>
+static inline int computeMandelbrotIteration(double cr, double ci, double ciSquared, int localLimit)
+{
+  // Inlined Cardioid/Bulb check using pre-calculated ciSquared
+  if (isInsideCardioidOrBulb(cr, ciSquared))
+  {
+    ++kernelExits.shortcut;
+    return localLimit;
+  }
+
+  const Real laneCr = static_cast<Real>(cr);
+  const Real laneCi = static_cast<Real>(ci);
+  OrbitLane<Real> lane;
+  startLane(lane);
+  while (stepLane(lane, laneCr, laneCi, localLimit))
+  {
+  }
+  countExit(lane, localLimit);
+
+  return lane.n;
+}
+
+/**
+ * Computes two pixels of the same row in one loop. Each orbit is a chain of
+ * dependent multiplies, and Broadway's FPU sits idle for most of every one of
+ * them, so stepping two independent chains side by side fills those gaps. Once
+ * either lane finishes, the survivor carries on alone in the scalar loop.
+ *
+ * With Real as double the counts match computeMandelbrotIteration bit for bit.
+ * With float it is the fast path for views zoomed far out, where a single
+ * precision orbit lands on the same counts and Broadway's single precision
+ * multiplies issue every cycle instead of every other. The paired-single unit would take both lanes in one instruction, but
+ * current GCC no longer exposes it, so the lanes stay two scalar chains
+ */
+template <typename Real = double>
+static inline void computeMandelbrotPair(
+  double cr1, double cr2, double ci, double ciSquared, int localLimit, int& n1, int& n2)
+{
+  const bool inside1 = isInsideCardioidOrBulb(cr1, ciSquared);
+  const bool inside2 = isInsideCardioidOrBulb(cr2, ciSquared);
+
+  // A lane the shortcut already settled has nothing to pair with
+  if (inside1 || inside2)
+  {
+    // A lane left over goes through the single kernel, which counts its own exit
+    kernelExits.shortcut += (inside1 ? 1 : 0) + (inside2 ? 1 : 0);
+    n1 = inside1 ? localLimit : computeMandelbrotIteration<Real>(cr1, ci, ciSquared, localLimit);
+    n2 = inside2 ? localLimit : computeMandelbrotIteration<Real>(cr2, ci, ciSquared, localLimit);
+    return;
+  }
+
+  const Real laneCr1 = static_cast<Real>(cr1);
+  const Real laneCr2 = static_cast<Real>(cr2);
+  const Real laneCi = static_cast<Real>(ci);
+  OrbitLane<Real> a;
+  OrbitLane<Real> b;
+  startLane(a);
+  startLane(b);
+
+  bool running1;
+  bool running2;
+  do
+  {
+    running1 = stepLane(a, laneCr1, laneCi, localLimit);
+    running2 = stepLane(b, laneCr2, laneCi, localLimit);
+  } while (running1 && running2);
+
+  while (running1)
+  {
+    running1 = stepLane(a, laneCr1, laneCi, localLimit);
+  }
+  while (running2)
+  {
+    running2 = stepLane(b, laneCr2, laneCi, localLimit);
+  }
+
+  countExit(a, localLimit);
+  countExit(b, localLimit);
+  n1 = a.n;
+  n2 = b.n;
+}
+
+/**
+ * Computes two pixels of one row with the pair kernel, in single precision
+ * when single is set
+ */
+static inline void computePair(bool single, double cr1, double cr2, double ci, double ciSquared, int localLimit, int& n1, int& n2)
+{
+  if (single)
+  {
+    computeMandelbrotPair<float>(cr1, cr2, ci, ciSquared, localLimit, n1, n2);
+    return;
+  }
+  computeMandelbrotPair(cr1, cr2, ci, ciSquared, localLimit, n1, n2);
+}
+
+/**
+ * Computes one pixel, in single precision when single is set
+ */
+static inline int computePixel(bool single, double cr, double ci, double ciSquared, int localLimit)
+{
+  if (single)
+  {
+    return computeMandelbrotIteration<float>(cr, ci, ciSquared, localLimit);
+  }
+  return computeMandelbrotIteration(cr, ci, ciSquared, localLimit);
+}
+
+/**
+ * An unevaluated sum of two doubles, hi carrying the value and lo what hi had
+ * to round away. Together they hold about 106 bits, enough to tell pixels
+ * apart down to a spacing near 1e-28
+ */
+struct DoubleDouble
+{
+  double hi;
+  double lo;
+};
+
+// A cardioid or bulb test made in plain doubles is only trusted for points
+// further inside than this, since a double view of a deeper pixel can land
+// on the wrong side of the edge
+static constexpr double DD_SHORTCUT_MARGIN = 1e-12;
+
+/**
+ * Sum of two doubles with the rounding error kept in lo. Exact for any
+ * inputs, and built only from additions, so a compiler fusing multiplies into
+ * adds cannot disturb it
+ */
+static inline DoubleDouble ddTwoSum(double a, double b)
+{
+  const double s = a + b;
+  const double bb = s - a;
+  return {s, (a - (s - bb)) + (b - bb)};
+}
+
+/**
+ * The same for when |a| >= |b| is already known, which saves three additions
+ */
+static inline DoubleDouble ddQuickTwoSum(double a, double b)
+{
+  const double s = a + b;
+  return {s, b - (s - a)};
+}
+
+static inline DoubleDouble ddAdd(DoubleDouble a, DoubleDouble b)
+{
+  DoubleDouble s = ddTwoSum(a.hi, b.hi);
+  s.lo += a.lo + b.lo;
+  return ddQuickTwoSum(s.hi, s.lo);
+}
+
+static inline DoubleDouble ddSub(DoubleDouble a, DoubleDouble b)
+{
+  return ddAdd(a, {-b.hi, -b.lo});
+}
+
+/**
+ * Product of two double-doubles. The fused multiply-add recovers the exact
+ * rounding error of hi * hi, which Broadway does in a single fmsub
+ */
+static inline DoubleDouble ddMul(DoubleDouble a, DoubleDouble b)
+{
+  const double p = a.hi * b.hi;
+  double e = std::fma(a.hi, b.hi, -p);
+  e += a.hi * b.lo + a.lo * b.hi;
+  return ddQuickTwoSum(p, e);
+}
+
+static inline DoubleDouble ddSqr(DoubleDouble a)
+{
+  const double p = a.hi * a.hi;
+  double e = std::fma(a.hi, a.hi, -p);
+  e += 2.0 * a.hi * a.lo;
+  return ddQuickTwoSum(p, e);
+}
+
+/**
+ * Computes the iteration count for a single pixel in double-double. Same loop
+ * as computeMandelbrotIteration, periodicity check included, with every value
+ * on the orbit carried at twice the precision. Only the escape test runs on hi
+ * alone, since a radius of 2 does not need the extra bits
+ */
+static inline int computeMandelbrotIterationDD(DoubleDouble cr, DoubleDouble ci, int localLimit)
+{
+  const double ciSquared = ci.hi * ci.hi;
+  const double crShift = cr.hi - CARD_P1;
+  const double q = crShift * crShift + ciSquared;
+  if (q * (q + crShift) <= CARD_P1 * ciSquared - DD_SHORTCUT_MARGIN
+    || ((cr.hi + 1.0) * (cr.hi + 1.0) + ciSquared) <= CARD_P2 - DD_SHORTCUT_MARGIN)
+  {
+    ++kernelExits.shortcut;
+    return localLimit;
+  }
+
+  DoubleDouble zr = {0, 0};
+  DoubleDouble zi = {0, 0};
+  DoubleDouble zrSquared = {0, 0};
+  DoubleDouble ziSquared = {0, 0};
+  DoubleDouble checkZr = {0, 0};
+  DoubleDouble checkZi = {0, 0};
+  int n = 0;
+  int count = 0;
+  int updateInterval = 1;
+
+  do
+  {
+    const DoubleDouble zrzi = ddMul(zr, zi);
+    zi = ddAdd({zrzi.hi * 2.0, zrzi.lo * 2.0}, ci);
+    zr = ddAdd(ddSub(zrSquared, ziSquared), cr);
+    zrSquared = ddSqr(zr);
+    ziSquared = ddSqr(zi);
+    ++n;
+
+    if (zr.hi == checkZr.hi && zr.lo == checkZr.lo && zi.hi == checkZi.hi && zi.lo == checkZi.lo)
+    {
+      kernelExits.iterations += static_cast<uint64_t>(n);
+      ++kernelExits.periodic;
+      return localLimit;
+    }
+
+    if (++count >= updateInterval)
+    {
+      checkZr = zr;
+      checkZi = zi;
+      count = 0;
+      updateInterval <<= 1;
+      if (updateInterval > 128)
+      {
+        updateInterval = 128;
+      }
+    }
+  } while (zrSquared.hi + ziSquared.hi < 4 && n != localLimit);
+
+  kernelExits.iterations += static_cast<uint64_t>(n);
+  if (n < localLimit)
+  {
+    ++kernelExits.escaped;
+  }
+  else
+  {
+    ++kernelExits.limit;
+  }
+  return n;
+}
+
+#endif // KERNEL_HPP
+
+// EOF
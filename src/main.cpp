@@ -10,11 +10,24 @@
 // the Free Software Foundation, either version 3 of the License, or
 // (at your option) any later version.
 
+#include "deepzoom.hpp"
+#include "field.hpp"
+#include "fieldcache.hpp"
+#include "gxdisplay.hpp"
+#include "kernel.hpp"
 #include "palettes.hpp"
-
-#include <algorithm> // For std::min, std::max
+#include "poster.hpp"
+#include "profiler.hpp"
+#include "render.hpp"
+#include "sdcard.hpp"
+#include "zoompath.hpp"
+
+#include <algorithm> // For std::min, std::max, std::fill
+#include <cfloat>
+#include <cmath>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ogcsys.h>
 #include <gccore.h>
 #include <wiiuse/wpad.h>
@@ -26,18 +39,139 @@
 static constexpr double INITIAL_ZOOM = 0.007;
 static constexpr int INITIAL_LIMIT = 200;
 static constexpr int LIMIT_MAX = 3200;
-static constexpr double MAX_ZOOM_PRECISION = 1e-14;
+// Deepest zoom the view centre's BigFixed fraction can still place to well
+// under a pixel
+static constexpr double MAX_ZOOM_PRECISION = 1e-60;
+
+// Once the pixel spacing is within this many double epsilons of the centre's
+// magnitude, rows carry their coordinates and orbits in double-double
+static constexpr double DD_ZOOM_ULPS = 1024.0;
+
+// Below this pixel spacing even double-double runs short, and views render by
+// perturbation around a BigFixed centre instead
+static constexpr double DEEP_ZOOM_THRESHOLD = 1e-28;
+
+// The fractal starts below the 20 scanline console strip
+static constexpr int FIELD_TOP = 20;
+
+// Block size of the first progressive pass. Each later pass halves it, so a
+// view shows one sample per 8x8 block first and takes three more passes to fill
+static constexpr int COARSE_STEP = 8;
+
+// Rectangles narrower or shorter than this are computed outright. Their border
+// is most of their area, so testing it first saves almost nothing
+static constexpr int SUBDIVIDE_MIN = 6;
+
+// Most edge pixels a finished field is antialiased at, about a third of the
+// screen, which only the busiest views come near. Past it the rest of the
+// edges stay single sampled
+static constexpr int EDGE_CAPACITY = 96 * 1024;
+
+// Number of pages the debug strip cycles through before switching off
+static constexpr int DEBUG_PAGE_COUNT = 10;
+
+// The automatic limit keeps the slowest escaping pixels below half the limit
+// and above a quarter of it, ignoring the last one in AUTO_LIMIT_TAIL of them
+// and never fewer than AUTO_LIMIT_STRAYS, so a handful of slow pixels in a
+// view that is nearly all interior leaves the limit alone. It never goes below
+// AUTO_LIMIT_MIN
+static constexpr u32 AUTO_LIMIT_TAIL = 500;
+static constexpr u32 AUTO_LIMIT_STRAYS = 8;
+static constexpr int AUTO_LIMIT_MIN = 50;
+
+// Slices of the limit the escape-count histogram is kept in
+static constexpr int HISTOGRAM_BINS = 16;
+
+// Width of each slice of the frame-time histogram. The last slice takes every
+// frame longer than the others cover
+static constexpr u32 FRAME_BIN_MICROS = 4000;
+
+// While the user is busy, computing a frame should take no longer than this,
+// which leaves a 30 fps frame room for input, text and the flip. Input counts
+// as stopped once no button that moves the view has been down for IDLE_FRAMES
+// frames
+static constexpr u32 RENDER_BUDGET_MICROS = 25000;
+static constexpr int IDLE_FRAMES = 30;
+static constexpr u32 VIEW_BUTTONS = WPAD_BUTTON_A | WPAD_BUTTON_B | WPAD_BUTTON_1 | WPAD_BUTTON_2 | WPAD_BUTTON_RIGHT;
+
+// While input continues, row renders stop at one sample per square of this
+// many pixels, and the pass that fills in the rest waits for the view to settle
+static constexpr int INTERACTIVE_STEP = 2;
+
+// Frames in a row the governor has to come in under half the budget before it
+// gives back a level of quality
+static constexpr int GOVERNOR_SETTLE_FRAMES = 20;
+
+// What the governor gives up, in order, when frames keep running over budget.
+// Level 0 is full quality and the only level used once input stops
+struct GovernorLevel
+{
+  // Block size of the first progressive pass
+  int coarseStep;
+  // Finest pass to compute while input continues. The rest wait for it to stop
+  int finestStep;
+  // The iteration limit is divided by 2 to this power
+  int limitShift;
+};
+
+static constexpr GovernorLevel GovernorLevels[] = {
+  {COARSE_STEP, 1, 0},
+  {COARSE_STEP, 4, 0},
+  {COARSE_STEP * 2, 4, 1},
+  {COARSE_STEP * 4, 8, 2}};
+static constexpr int GOVERNOR_LEVEL_COUNT = sizeof(GovernorLevels) / sizeof(GovernorLevels[0]);
+
+// How far one press of A zooms in
+static constexpr double ZOOM_STEP = 0.35;
+
+// How far one press zooms in with grid zoom on. Halving the spacing about a
+// pixel of the old view puts every other pixel of every other row of the new
+// one on an old pixel, which keeps its count
+static constexpr double GRID_ZOOM_STEP = 0.5;
+
+// Frames A has to stay down before the view zooms continuously, and how far
+// each frame of that goes. At 60 frames a second, 0.97 covers one press worth
+// of zoom in a little over half a second
+static constexpr int HOLD_DELAY_FRAMES = 15;
+static constexpr double HOLD_ZOOM_STEP = 0.97;
+
+// Pixels a frame the D-pad pans while B is held
+static constexpr int PAN_STEP = 4;
+
+// How a new view is computed into the field. Every engine produces the same
+// layout, so packing and the debug strip do not care which one ran
+enum class RenderEngine
+{
+  Rows,
+  Subdivide,
+  Trace
+};
+
+static constexpr int RENDER_ENGINE_COUNT = 3;
+static const char* const RenderEngineNames[RENDER_ENGINE_COUNT] = {"Rows", "Subdivide", "Trace"};
+
+// The arithmetic a view needs, picked from its depth. Only the float and
+// double tiers run every engine; the others always render in rows
+enum class PrecisionTier
+{
+  Float,
+  Double,
+  DoubleDouble,
+  Perturbation
+};
+
+static constexpr int PRECISION_TIER_COUNT = 4;
+static const char* const PrecisionTierNames[PRECISION_TIER_COUNT] = {"Float", "Double", "DD", "Pert"};
+
+static inline bool runsEveryEngine(PrecisionTier tier)
+{
+  return tier == PrecisionTier::Float || tier == PrecisionTier::Double;
+}
 
 // The debug strip prints Iter and AvgIterPx four columns wide each, and neither
 // can exceed the limit
 static_assert(LIMIT_MAX <= 9999, "Iter and AvgIterPx fields are four columns wide");
-
-// Pre-computed constants for cardioid/bulb check
-static constexpr double CARD_P1 = 0.25;
-static constexpr double CARD_P2 = 0.0625;
-
-// Color constant for points inside the set (Black in YUV: Y=0, U=128, V=128)
-static const uint8_t Black[3] = {0, 128, 128};
+static_assert(LIMIT_MAX < FIELD_PENDING, "Counts have to stay clear of the pending marker");
 
 static u32* xfb[2] = {nullptr, nullptr};
 static GXRModeObj* rmode;
@@ -47,8 +181,13 @@ static volatile bool reboot = false;
 static volatile bool switchoff = false;
 // The buffer's 32-byte alignment comes from aligned_alloc at the call site;
 // qualifying the pointer here would only align the pointer itself
-static int* field = nullptr;
+static FieldCount* field = nullptr;
+// The field's tile summaries, brought up to date whenever the field changes
+static FieldTile* fieldTiles = nullptr;
 static u64 lastTime = 0;
+// Set once GX is ready to do the palette lookup. Without it the CPU packs
+// every frame as it always did
+static bool gxPalette = false;
 
 // Debug strip readings, held between the frame loop that measures them and the
 // display that prints them. The iteration totals describe whatever the field
@@ -56,13 +195,199 @@ static u64 lastTime = 0;
 static u32 lastRenderMicros = 0;
 static u64 fieldIterSum = 0;
 static u32 fieldIterPixels = 0;
+// Pixels an engine wrote without iterating them, counted alongside the
+// computed ones in fieldIterPixels
+static u32 fieldFilledPixels = 0;
+// Pixels a grid zoom or a raised limit carried over from the field before,
+// which no engine computed or filled
+static u32 fieldCarriedPixels = 0;
+// Pixels or lattice samples the last drag computed along the edges it
+// uncovered, or -1 once the view has rendered from scratch since
+static int fieldPanPixels = -1;
+// Pixels that differ from the row engine when the field was last checked
+// against it, or -1 if this field has not been checked
+static int fieldMismatches = -1;
+// Highest average count of any tile, from the last heatmap drawn
+static u32 fieldHottestTile = 0;
+// Time the edge pass last took over a whole field, summed over the jobs it
+// was split across
+static u32 edgeMicros = 0;
+// Number of the last trace written to the SD card, -1 if writing it failed,
+// or -2 before the first try
+static int traceFile = -2;
+// Which tier and engine drew the field, and what the perturbation renderer
+// reported when it was the one
+static PrecisionTier fieldTier = PrecisionTier::Double;
+static const char* fieldEngineName = RenderEngineNames[0];
+static DeepStats deepStats = {0, 0, 0, 0, 0};
+// Time each tier last spent computing a whole view, summed over the frames of
+// a progressive render
+static u32 tierRenderMicros[PRECISION_TIER_COUNT] = {0, 0, 0, 0};
+
+// Escape counts of the last finished field in equal slices of its limit, and
+// the pixels that reached the limit
+static u32 limitHistogram[HISTOGRAM_BINS] = {};
+static u32 fieldInterior = 0;
+
+// The frame-time governor: the level it runs at while input continues, how
+// far over budget the last frame computed, and how many frames in a row have
+// been comfortably inside it
+static int governorLevel = 0;
+static int governorOverMicros = 0;
+static int governorCalmFrames = 0;
+
+// The render thread, when there is one. Each job it runs is the computeField
+// a frame would otherwise make itself, and until the job is done the field
+// and the view's render state are the thread's, so a long render never holds
+// up the frame loop. renderBusy is set while a job runs, renderCancel asks it
+// to stop at the next row or tile, and renderChanged says whether jobs since
+// the frame loop last looked changed the field
+static lwp_t renderThread = LWP_THREAD_NULL;
+static mutex_t renderMutex;
+static cond_t renderCond;
+static volatile bool renderBusy = false;
+static volatile bool renderCancel = false;
+static volatile bool renderQuit = false;
+static bool renderChanged = false;
+static int renderScreenW = 0;
+static int renderScreenH = 0;
+
+// Microseconds the frame loop has held the CPU for, which a job waits out at
+// the thread's lower priority, and when the loop last took it. A job's time
+// for the governor leaves out what the loop took while it ran. The total is
+// 32 bits so the thread never reads it half written, and wraps after an hour
+static volatile u32 frameLoopMicros = 0;
+static u64 frameLoopWoke = 0;
+
+// What a job reads of the state the frame loop's input writes. The loop
+// copies it into renderJob before each job, and clears the requests the job
+// before served, so the two threads never share the state's own fields
+struct RenderJob
+{
+  bool interacting;
+  bool progressive;
+  bool antialias;
+  bool checkRequested;
+  bool markRequested;
+  // Set by the job once it has done what checkRequested or markRequested asked
+  bool checkServed;
+  bool markServed;
+};
+static RenderJob renderJob = {};
+
+// Below the frame loop's priority, so the thread computes whenever the loop
+// waits for the flip and gives way the moment it wakes
+static constexpr u8 RENDER_PRIORITY = 32;
+static constexpr u32 RENDER_STACK_SIZE = 64 * 1024;
+
+// Work buffers for the tracing engine, allocated the first time it runs. The
+// queue holds field offsets and never wraps, since no pixel enters it twice
+static u32* traceQueue = nullptr;
+static uint8_t* traceQueued = nullptr;
+
+// Counts a grid zoom or a raised limit carries over, at their place in the new
+// view, with the rest pending. Allocated the first time either happens, and
+// only read while carryActive says it belongs to the view being rendered
+static FieldCount* carryField = nullptr;
+static bool carryActive = false;
+
+// The finished field's edges and their sub-pixel samples, allocated the first
+// time a field is antialiased. edgesFound says the list is complete, and
+// edgeSampled how much of it has been sampled, which is where a cancelled job
+// picks up. edgeSerial moves on each time the list is thrown away, so the GX
+// overlay knows to clear what it showed
+static FieldEdge* fieldEdges = nullptr;
+static int edgeCount = 0;
+static int edgeSampled = 0;
+static bool edgesFound = false;
+static u32 edgeSerial = 0;
+
+// Poster widths 1 and 2 step through on the poster page. The height follows
+// from the field's shape
+static constexpr int PosterWidths[] = {2048, 4096, 8192, 16384};
+static constexpr int POSTER_WIDTH_COUNT = sizeof(PosterWidths) / sizeof(PosterWidths[0]);
+
+// The poster being written to SD, if any. While posterActive is set the view
+// holds still and each job the render thread runs is the next band, or each
+// frame renders one without the thread. posterWritten is false once a band
+// was cancelled or could not be written, and posterFile is the number of the
+// last poster finished, -1 if it failed, or -2 before the first
+static PosterJob poster;
+static FILE* posterOut = nullptr;
+static char posterPath[32];
+static int posterNumber = 0;
+static int posterPalette = 0;
+static volatile bool posterActive = false;
+static volatile bool posterWritten = true;
+static int posterFile = -2;
+static u64 posterStart = 0;
+
+// Where the zoom path page reads its keyframes, and the largest file it takes
+static constexpr const char* PATH_FILE = "sd:/wmcpp-path.txt";
+static constexpr long PATH_FILE_BYTES = 16 * 1024;
+
+// The zoom path being rendered to SD, if any. Frames take turns in the two
+// buffers: while pathActive is set each job the render thread runs is frame
+// pathFrame, and the frame loop writes the one before it out in the meantime,
+// or renders and writes a frame each time round without the thread.
+// pathRendered is false once a frame was cancelled or ran out of memory, and
+// pathFile is the number of the last video, -1 if it failed, or -2 before the
+// first. pathBadLine is the line of the path file that could not be read
+static ZoomPath zoomPath;
+static ZoomPathWriter pathWriter;
+static FieldCount* pathFields[2] = {nullptr, nullptr};
+static PosterView pathViews[2];
+static FILE* pathOut = nullptr;
+static int pathFrame = 0;
+static int pathNumber = 0;
+static volatile bool pathActive = false;
+static volatile bool pathRendered = true;
+static int pathFile = -2;
+static int pathBadLine = 0;
+static u64 pathStart = 0;
 
 void reset(u32, void*);
 void poweroff();
 
+/**
+ * Rounds a BigFixed to double-double: the nearest double, then the nearest
+ * double to what that left over
+ */
+static inline DoubleDouble toDoubleDouble(const BigFixed& value)
+{
+  const double hi = BigFixedToDouble(value);
+  const double lo = BigFixedToDouble(BigFixedAdd(value, BigFixedNegate(BigFixedFromDouble(hi))));
+  return {hi, lo};
+}
+
+/**
+ * Works out where the real axis falls, for mirroring rows across it. Row h's
+ * ci is the negative of row (base - h)'s, give or take half a pixel, since the
+ * axis rarely falls exactly on a row or midway between two. exact says whether
+ * it does, so that the mirror stands for the very same point
+ *
+ * @return The sum of any row and its mirror
+ */
+static int mirrorBase(double centerY, double zoom, int screenH2, bool& exact)
+{
+  // Rows sit at ci = -(h - screenH2) * zoom - centerY, so a pair whose ci
+  // cancel sums to 2 * screenH2 - 2 * centerY / zoom. An axis far off screen
+  // only has to stay far off screen, and clamping keeps the sum an int
+  const double rows = std::clamp(-2.0 * centerY / zoom, -8.0 * screenH2, 8.0 * screenH2);
+  exact = (rows == std::round(rows));
+  return 2 * screenH2 + static_cast<int>(std::lround(rows));
+}
+
 class MandelbrotState
 {
 public:
+  // The centre at full precision. centerX and centerY are its nearest
+  // doubles, which is all any view short of the deep zoom threshold needs
+  BigFixed preciseX;
+  BigFixed preciseY;
+  // The same centre rounded to double-double, for the middle tier
+  DoubleDouble ddCenterX;
+  DoubleDouble ddCenterY;
   double centerX;
   double centerY;
   double oldX;
@@ -73,12 +398,102 @@ public:
   uint8_t paletteIndex;
   double zoom;
   bool process;
+  RenderEngine engine;
+  bool progressive;
+  // Block size of the next progressive pass, or 0 once the view is complete,
+  // and the row the pass has reached when the governor split it across frames.
+  // The passes sample the pixels latticeCol and latticeRow on from column 0
+  // and row FIELD_TOP in steps of their block size. A drag over a field still
+  // refining moves the lattice with the picture
+  int refineStep;
+  int refineRow;
+  int latticeCol;
+  int latticeRow;
+  // The limit the field was rendered with. The governor can cap it below
+  // limit while input continues, and sets degraded when it did that or drew
+  // the view some other way than asked
+  int fieldLimit;
+  bool degraded;
+  // Frames since a button that changes the view was down, up to IDLE_FRAMES
+  int idleFrames;
+  // Pixels the view has been dragged since the field last caught up
+  int panX;
+  int panY;
+  // A zooms by GRID_ZOOM_STEP rather than ZOOM_STEP while gridZoom is on. A
+  // grid zoom from a finished field leaves the old pixel that became the
+  // centre in carryCol and carryRow, and the zoom and centre it went to in
+  // carryZoom, carryX and carryY, so the render can tell the view has not
+  // moved on since. carryZoom is 0 otherwise. carryMirror is the sum of any
+  // row of the old view and its mirror when mirroring was only close, or 0.
+  // When the automatic limit doubles, the view carries its own field over the
+  // same way, and carryRaised counts the pixels that escaped short of the old
+  // limit. It is 0 after a grid zoom
+  bool gridZoom;
+  int carryCol;
+  int carryRow;
+  double carryZoom;
+  double carryX;
+  double carryY;
+  int carryMirror;
+  u32 carryRaised;
+  // Where the pointer was when B last saw it, whether that sighting can be
+  // dragged from, and whether B has dragged since it went down. A press that
+  // never drags starts over when released
+  int dragX;
+  int dragY;
+  bool dragTracking;
+  bool dragged;
   bool cycling;
   int cycle;
   bool debugMode;
+  int debugPage;
+  // Set by D-pad Left in debug mode, and cleared once the finished field has
+  // been checked against the row engine, or on the frame page once the frame
+  // times have been written out
+  bool checkRequested;
+  bool traceRequested;
+  // Set by D-pad Left on the poster page, and cleared once the poster starts
+  bool posterRequested;
+  // Index into PosterWidths of the next poster's width
+  int posterWidth;
+  // Set by D-pad Left on the zoom path page, and cleared once the path starts
+  bool pathRequested;
+  // Set when the field has changed since it was last saved to the cache, and
+  // by D-pad Left on the cache page until the view is bookmarked. markIndex is
+  // the bookmark 1 and 2 last went to. cacheSkip renders the next view
+  // rather than load it, once a loaded field turned out to need a higher limit
+  bool cachePending;
+  bool markRequested;
+  int markIndex;
+  bool cacheSkip;
+  // The last rendered field scaled to stand in for a view still being
+  // computed: the field pixel under the screen centre, and how many field
+  // pixels one screen pixel spans. A scale of 1 means no preview
+  double previewCol;
+  double previewRow;
+  double previewScale;
+  // Set when a zoom has not been shown yet. That frame shows the preview and
+  // leaves the render to the next one
+  bool previewFresh;
+  // A has been held past HOLD_DELAY_FRAMES, so the view is still moving and
+  // rendering waits for the release
+  bool zoomHeld;
+  int heldFrames;
+  // The limit follows the escape-count histogram until 1 or 2 sets it by
+  // hand. A limit the histogram says is too high waits for the next view,
+  // since lowering it would turn pixels already drawn into interior
+  bool autoLimit;
+  int nextLimit;
+  // A finished field takes extra samples across its edges once input stops,
+  // until 2 on the precision page turns that off
+  bool antialias;
 
   MandelbrotState()
   {
+    preciseX = BigFixedFromDouble(0.0);
+    preciseY = preciseX;
+    ddCenterX = {0, 0};
+    ddCenterY = {0, 0};
     centerX = 0;
     centerY = 0;
     oldX = 0;
@@ -89,9 +504,51 @@ public:
     paletteIndex = 4;
     zoom = INITIAL_ZOOM;
     process = true;
+    engine = RenderEngine::Rows;
+    progressive = true;
+    refineStep = 0;
+    refineRow = FIELD_TOP;
+    latticeCol = 0;
+    latticeRow = 0;
+    fieldLimit = INITIAL_LIMIT;
+    degraded = false;
+    idleFrames = IDLE_FRAMES;
+    panX = 0;
+    panY = 0;
+    gridZoom = false;
+    carryCol = 0;
+    carryRow = 0;
+    carryZoom = 0;
+    carryX = 0;
+    carryY = 0;
+    carryMirror = 0;
+    carryRaised = 0;
+    dragX = 0;
+    dragY = 0;
+    dragTracking = false;
+    dragged = false;
     cycling = false;
     cycle = 0;
     debugMode = false;
+    debugPage = 0;
+    checkRequested = false;
+    traceRequested = false;
+    posterRequested = false;
+    posterWidth = 1;
+    pathRequested = false;
+    cachePending = false;
+    markRequested = false;
+    markIndex = -1;
+    cacheSkip = false;
+    previewCol = 0;
+    previewRow = 0;
+    previewScale = 1.0;
+    previewFresh = false;
+    zoomHeld = false;
+    heldFrames = 0;
+    autoLimit = true;
+    antialias = true;
+    nextLimit = 0;
   }
 
   // Passed by reference throughout, so a copy would silently diverge from
@@ -101,22 +558,174 @@ public:
 
   inline void moveView(int screenW2, int screenH2)
   {
-    centerX = mouseX * zoom - screenW2 * zoom + oldX;
+    // The step is a whole number of pixels, which a double holds exactly at
+    // any depth. Only the running sum needs the extra bits
+    shiftCenter((mouseX - screenW2) * zoom, (mouseY - screenH2) * zoom);
+    process = true;
+  }
+
+  inline void shiftCenter(double stepX, double stepY)
+  {
+    setCenter(BigFixedAdd(preciseX, BigFixedFromDouble(stepX)), BigFixedAdd(preciseY, BigFixedFromDouble(stepY)));
+  }
+
+  inline void setCenter(const BigFixed& x, const BigFixed& y)
+  {
+    preciseX = x;
+    preciseY = y;
+    ddCenterX = toDoubleDouble(preciseX);
+    ddCenterY = toDoubleDouble(preciseY);
+    centerX = ddCenterX.hi;
     oldX = centerX;
-    centerY = mouseY * zoom - screenH2 * zoom + oldY;
+    centerY = ddCenterY.hi;
     oldY = centerY;
+  }
+
+  inline void resetView()
+  {
+    zoom = INITIAL_ZOOM;
+    preciseX = BigFixedFromDouble(0.0);
+    preciseY = preciseX;
+    ddCenterX = ddCenterY = {0, 0};
+    centerX = centerY = oldX = oldY = 0;
     process = true;
+    previewScale = 1.0;
+  }
+
+  /**
+   * Goes straight to a view saved in the cache, at the limit it was saved with
+   */
+  inline void jumpTo(const FieldFileView& view)
+  {
+    setCenter(view.centerX, view.centerY);
+    zoom = view.zoom;
+    limit = view.limit;
+    nextLimit = 0;
+    process = true;
+    previewScale = 1.0;
+  }
+
+  inline PrecisionTier precisionTier() const
+  {
+    if (zoom < DEEP_ZOOM_THRESHOLD)
+    {
+      return PrecisionTier::Perturbation;
+    }
+
+    const double scale = precisionScale(centerX, centerY);
+    if (zoom < DD_ZOOM_ULPS * DBL_EPSILON * scale)
+    {
+      return PrecisionTier::DoubleDouble;
+    }
+
+    if (zoom >= FLOAT_ZOOM_ULPS * FLT_EPSILON * scale)
+    {
+      return PrecisionTier::Float;
+    }
+
+    return PrecisionTier::Double;
   }
 
+
   inline void zoomView(int screenW2, int screenH2)
   {
+    const double before = zoom;
+    const bool carry = gridZoom && !process && refineStep == 0 && !degraded && panX == 0 && panY == 0;
+
+    // Rows copied across the real axis stand for a point up to half a pixel
+    // away, which each later zoom would double, so those stay behind
+    bool exact;
+    const int mirrorSum = mirrorBase(centerY, zoom, screenH2, exact);
+    carryMirror = exact ? 0 : mirrorSum;
+    carryCol = mouseX;
+    carryRow = mouseY;
+
     moveView(screenW2, screenH2);
-    zoom *= 0.35;
+    zoom *= gridZoom ? GRID_ZOOM_STEP : ZOOM_STEP;
     if (zoom < MAX_ZOOM_PRECISION)
     {
       zoom = MAX_ZOOM_PRECISION;
     }
     process = true;
+    zoomPreview(zoom / before, true, screenW2, screenH2);
+
+    carryZoom = (carry && zoom == before * GRID_ZOOM_STEP) ? zoom : 0;
+    carryX = centerX;
+    carryY = centerY;
+    carryRaised = 0;
+  }
+
+  /**
+   * Whether the view is still the one a grid zoom from a finished field went
+   * to, so the field still holds what that zoom can carry over
+   */
+  inline bool carryReady() const
+  {
+    return carryZoom != 0 && carryZoom == zoom && carryX == centerX && carryY == centerY;
+  }
+
+  /**
+   * Zooms by factor while the point under the cursor stays where it is, for
+   * the small steps of a held A
+   */
+  inline void zoomTowards(double factor, int screenW2, int screenH2)
+  {
+    const double before = zoom;
+    zoom = std::max(zoom * factor, MAX_ZOOM_PRECISION);
+
+    // The centre moves by the share of the cursor's offset the zoom took away
+    const double shift = before - zoom;
+    shiftCenter((mouseX - screenW2) * shift, (mouseY - screenH2) * shift);
+    process = true;
+    zoomPreview(zoom / before, false, screenW2, screenH2);
+  }
+
+  /**
+   * Drags the picture by whole pixels, so every count still on screen stays
+   * exact for its new position. The field follows on the next frame
+   */
+  inline void panView(int dx, int dy)
+  {
+    shiftCenter(-dx * zoom, -dy * zoom);
+    panX += dx;
+    panY += dy;
+
+    // A preview on screen is dragged along with the view it stands in for
+    if (previewing())
+    {
+      previewCol -= dx * previewScale;
+      previewRow -= dy * previewScale;
+    }
+  }
+
+  /**
+   * Follows a zoom with the preview, so it keeps showing the old field where
+   * the new view will be. The cursor's field pixel either moves to the centre
+   * or stays under the cursor
+   */
+  inline void zoomPreview(double factor, bool recentre, int screenW2, int screenH2)
+  {
+    if (previewScale == 1.0)
+    {
+      previewCol = screenW2;
+      previewRow = screenH2;
+    }
+
+    const double keep = recentre ? 1.0 : (1.0 - factor);
+    previewCol += (mouseX - screenW2) * previewScale * keep;
+    previewRow += (mouseY - screenH2) * previewScale * keep;
+    previewScale *= factor;
+    previewFresh = true;
+  }
+
+  inline bool previewing() const
+  {
+    return previewScale < 1.0;
+  }
+
+  inline bool interacting() const
+  {
+    return idleFrames < IDLE_FRAMES;
   }
 };
 
@@ -131,281 +740,2196 @@ void poweroff()
 }
 
 /**
- * Packs two adjacent pixels' YUV values into the Wii's native framebuffer format.
- * The Wii uses an interleaved YUV format where two pixels share chrominance (U,V)
- * values to save memory bandwidth. The resulting 32-bit value contains two Y
- * (luminance) values with shared U and V components between adjacent pixels.
- *
- * @param n1 First pixel's iteration count
- * @param n2 Second pixel's iteration count
- * @param limit Maximum iteration count
- * @param cycle Palette rotation offset, applied only to points that escaped
- * @param palette Current color palette pointer
- * @return Packed 32-bit YUV value ready for framebuffer
+ * Computes one pixel in double-double. The offset from the centre is a whole
+ * number of pixels, which a double holds to far better than a pixel, so only
+ * the sum with the centre needs the extra bits
  */
-static inline u32 PackYUVPair(int n1, int n2, int limit, int cycle, PalettePtr palette)
+static inline int sampleDoubleDouble(const MandelbrotState& state, int w, int h, int screenW2, int screenH2)
 {
-  // A count of exactly limit means the point never escaped and belongs to the
-  // set, so it stays black and only the escape counts take the rotation
-  const uint8_t* p1 = (n1 == limit) ? Black : palette[(n1 + cycle) & 255];
-  const uint8_t* p2 = (n2 == limit) ? Black : palette[(n2 + cycle) & 255];
-
-  // Pack Y1, Average U, Y2, Average V
-  return (p1[0] << 24) | ((p1[1] + p2[1]) >> 1 << 16) | (p2[0] << 8) | ((p1[2] + p2[2]) >> 1);
+  const DoubleDouble cr = ddAdd(state.ddCenterX, {(w - screenW2) * state.zoom, 0});
+  const DoubleDouble ci = ddSub({-1.0 * (h - screenH2) * state.zoom, 0}, state.ddCenterY);
+  return computeMandelbrotIterationDD(cr, ci, state.fieldLimit);
 }
 
 /**
- * Checks if a point is inside the main Cardioid or the period-2 Bulb.
- * Extracted to reduce cyclomatic complexity of the main compute function.
+ * Renders a single row in double-double
+ *
+ * @return Total iteration count across the row, for the debug strip's average
  */
-static inline bool isInsideCardioidOrBulb(double cr, double ciSquared)
+static u32 renderRowDD(const MandelbrotState& state, FieldCount* rowField, int h, int screenW, int screenW2, int screenH2)
 {
-  // q = (x - 1/4)^2 + y^2
-  double q = (cr - CARD_P1) * (cr - CARD_P1) + ciSquared;
+  u32 rowSum = 0;
 
-  // Cardioid: q * (q + (x - 1/4)) <= 1/4 * y^2
-  if (q * (q + (cr - CARD_P1)) <= CARD_P1 * ciSquared)
-  {
-    return true;
-  }
-  // Period-2 Bulb: (x + 1)^2 + y^2 <= 1/16
-  if (((cr + 1.0) * (cr + 1.0) + ciSquared) <= CARD_P2)
+  for (int w = 0; w < screenW; ++w)
   {
-    return true;
+    rowField[w] = static_cast<FieldCount>(sampleDoubleDouble(state, w, h, screenW2, screenH2));
+    rowSum += static_cast<u32>(rowField[w]);
   }
 
-  return false;
+  return rowSum;
 }
 
 /**
- * Computes the iteration count for a single Mandelbrot pixel
+ * Renders a row carried counts went into, iterating only the pixels they
+ * left pending. Those are taken in pairs, however far apart, so the pair kernel
+ * still does the work
+ *
+ * @return Total iteration count across the pixels computed
  */
-static inline int computeMandelbrotIteration(double cr, double ci, double ciSquared, int localLimit)
+static u32 renderRowCarried(
+  const MandelbrotState& state,
+  FieldCount* rowField,
+  const FieldCount* rowCarry,
+  int h,
+  int screenW,
+  int screenW2,
+  int screenH2,
+  u32& samples)
 {
-  // Inlined Cardioid/Bulb check using pre-calculated ciSquared
-  if (isInsideCardioidOrBulb(cr, ciSquared))
-  {
-    return localLimit;
-  }
-
-  double zr = 0;
-  double zi = 0;
-  int n = 0;
-  double zrSquared = 0;
-  double ziSquared = 0;
-
-  double checkZr = 0;
-  double checkZi = 0;
-  int updateInterval = 1;
-  int count = 0;
+  const double rowStart = -screenW2 * state.zoom + state.centerX;
+  const double ci = -1.0 * (h - screenH2) * state.zoom - state.centerY;
+  const double ciSquared = ci * ci;
+  const bool single = (fieldTier == PrecisionTier::Float);
+  u32 rowSum = 0;
+  int waiting = -1;
+  samples = 0;
 
-  do
+  for (int w = 0; w < screenW; ++w)
   {
-    zi = (zr + zr) * zi + ci;
-    zr = zrSquared - ziSquared + cr;
-    zrSquared = zr * zr;
-    ziSquared = zi * zi;
-    ++n;
-
-    if (zr == checkZr && zi == checkZi)
+    if (rowCarry[w] != FIELD_PENDING)
     {
-      return localLimit;
+      rowField[w] = rowCarry[w];
+      continue;
     }
 
-    if (++count >= updateInterval)
+    ++samples;
+    if (fieldTier == PrecisionTier::DoubleDouble)
     {
-      checkZr = zr;
-      checkZi = zi;
-      count = 0;
-      updateInterval <<= 1;
-      if (updateInterval > 128)
-      {
-        updateInterval = 128;
-      }
+      rowField[w] = static_cast<FieldCount>(sampleDoubleDouble(state, w, h, screenW2, screenH2));
+      rowSum += static_cast<u32>(rowField[w]);
+    }
+    else if (waiting < 0)
+    {
+      waiting = w;
+    }
+    else
+    {
+      int n1;
+      int n2;
+      computePair(single, rowStart + waiting * state.zoom, rowStart + w * state.zoom, ci, ciSquared,
+        state.fieldLimit, n1, n2);
+      rowField[waiting] = static_cast<FieldCount>(n1);
+      rowField[w] = static_cast<FieldCount>(n2);
+      rowSum += static_cast<u32>(n1 + n2);
+      waiting = -1;
     }
-  } while (zrSquared + ziSquared < 4 && n != localLimit);
+  }
+
+  if (waiting >= 0)
+  {
+    rowField[waiting] = static_cast<FieldCount>(
+      computePixel(single, rowStart + waiting * state.zoom, ci, ciSquared, state.fieldLimit));
+    rowSum += static_cast<u32>(rowField[waiting]);
+  }
 
-  return n;
+  return rowSum;
 }
 
 /**
- * Renders a single row of the Mandelbrot set.
- * Extracted to reduce line count of renderMandelbrot.
- *
- * @return Total iteration count across the row, for the debug strip's average
+ * Writes one sample into every pixel of the block it stands for, clipped to the
+ * field. Later passes overwrite all of the block but the sample's own corner,
+ * which keeps the value the block was filled with
  */
-static u32 renderRow(const MandelbrotState& state, int h, int screenW, double rowCr, double ci, double ciSquared)
+static inline void fillBlock(FieldCount* blockField, int value, int rows, int cols, int screenW)
 {
-  int* rowField = field + (screenW * h);
-  int w = 0;
-  int localLimit = state.limit;
-  double localZoom = state.zoom;
-  u32 rowSum = 0;
-
-  do
+  for (int y = 0; y < rows; ++y)
   {
-    // Two pixels per pass, so the running coordinate takes one addition per pair
-    // instead of one per pixel and accumulates half as much rounding error
-    int n1 = computeMandelbrotIteration(rowCr, ci, ciSquared, localLimit);
-    int n2 = computeMandelbrotIteration(rowCr + localZoom, ci, ciSquared, localLimit);
-    rowField[w] = n1;
-    rowField[w + 1] = n2;
-    rowSum += static_cast<u32>(n1 + n2);
-    w += 2;
-    rowCr += 2.0 * localZoom;
-  } while (w < screenW);
-
-  return rowSum;
+    for (int x = 0; x < cols; ++x)
+    {
+      blockField[x] = static_cast<FieldCount>(value);
+    }
+    blockField += screenW;
+  }
 }
 
-
 /**
- * Renders the Mandelbrot set to the framebuffer
+ * Computes one level of the progressive render. The first pass takes every
+ * sample on a step-sized lattice. Each later pass takes only the samples that
+ * are on its lattice but not on the one twice as coarse, so the passes together
+ * compute every pixel exactly once, the same work as a full render. A pixel is
+ * on the lattice of a step when it is a whole number of steps from the
+ * lattice origin, so each step's first row and column can be past the first.
+ * The rows and columns before them hold what a coarser pass or a drag left.
+ *
+ * The pass starts at row and stops after the first row that ends past
+ * deadline, leaving row where the next frame picks it up. A deadline of 0
+ * runs the pass to the end
+ *
+ * @return Total iteration count across the rows computed, for the debug
+ * strip's average
  */
-static void renderMandelbrot(
-  MandelbrotState& state,
-  u32* framebuffer,
-  PalettePtr currentPalette,
+static u32 renderRefinePass(
+  const MandelbrotState& state,
+  int step,
+  bool firstPass,
+  int& row,
+  u64 deadline,
   int screenW,
   int screenH,
   int screenW2,
-  int screenH2)
+  int screenH2,
+  u32& samples)
 {
-  // Cache state variables locally to allow the compiler to use registers
-  const int localLimit = state.limit;
+  const int localLimit = state.fieldLimit;
   const double localZoom = state.zoom;
-  const double localCenterX = state.centerX;
-  const double localCenterY = state.centerY;
-  const bool localProcess = state.process;
-  const int localCycle = state.cycle;
-
-  if (localProcess)
-  {
-    fieldIterSum = 0;
-    fieldIterPixels = 0;
-  }
-
-  int h = 20; // Fractal rendering starts below the console area
-  do
+  const double rowStart = -screenW2 * localZoom + state.centerX;
+  const bool doubleDouble = (fieldTier == PrecisionTier::DoubleDouble);
+  const bool single = (fieldTier == PrecisionTier::Float);
+  bool mirrorExact;
+  const int mirrorSum = mirrorBase(state.centerY, state.zoom, screenH2, mirrorExact);
+  u32 passSum = 0;
+  samples = 0;
+
+  // Steps are powers of two, so masking finds the lattice for any origin
+  const int coarser = (step << 1) - 1;
+  const int start = (row == FIELD_TOP) ? FIELD_TOP + (state.latticeRow & (step - 1)) : row;
+  for (int h = start; h < screenH; h += step)
   {
-    int screenWH = screenW * h;
-
-    if (localProcess)
+    if (renderCancel || (deadline != 0 && h != start && gettime() > deadline))
     {
-      double ci = -1.0 * (h - screenH2) * localZoom - localCenterY;
-      double ciSquared = ci * ci; // Calculate once per row
-      // Render the row data if processing is needed
-      fieldIterSum += renderRow(state, h, screenW, -screenW2 * localZoom + localCenterX, ci, ciSquared);
-      fieldIterPixels += static_cast<u32>(screenW);
+      row = h;
+      return passSum;
     }
 
-    // Draw pixels to XFB
-    int* rowField = field + screenWH;
-    u32* rowXfb = framebuffer + (screenWH >> 1);
-    int w = 0;
+    // Rows on an odd multiple of step are new in this pass. The rest already
+    // hold the even columns from the coarser passes
+    const bool newRow = firstPass || ((h - FIELD_TOP - state.latticeRow) & coarser) != 0;
+    const int colStride = newRow ? step : step << 1;
+    const int firstCol = newRow ? (state.latticeCol & (step - 1)) : ((state.latticeCol + step) & coarser);
+    const int rows = std::min(step, screenH - h);
+    const double ci = -1.0 * (h - screenH2) * localZoom - state.centerY;
+    const double ciSquared = ci * ci;
+    FieldCount* rowField = field + (screenW * h);
+    const FieldCount* rowCarry = carryActive ? carryField + (screenW * h) : nullptr;
+
+    // A mirror above this row on the same lattice, and new in this pass when
+    // this row is, took its samples from the same columns already
+    const int mirror = mirrorSum - h;
+    if (mirror >= FIELD_TOP && mirror < h && ((mirror - FIELD_TOP - state.latticeRow) & (step - 1)) == 0
+      && (firstPass || (((mirror - FIELD_TOP - state.latticeRow) & coarser) != 0) == newRow))
+    {
+      const FieldCount* mirrorField = field + (screenW * mirror);
+      for (int w = firstCol; w < screenW; w += colStride)
+      {
+        fillBlock(rowField + w, mirrorField[w], rows, std::min(step, screenW - w), screenW);
+        ++fieldFilledPixels;
+      }
+      continue;
+    }
 
-    do
+    for (int w = firstCol; w < screenW; w += colStride << 1)
     {
-      // Retrieve iteration counts using pointer arithmetic
-      int n1 = rowField[w];
-      int n2 = rowField[w + 1];
-      // Write to XFB using pointer arithmetic
-      rowXfb[w >> 1] = PackYUVPair(n1, n2, localLimit, localCycle, currentPalette);
-      w += 2;
-    } while (w < screenW);
+      const int w2 = w + colStride;
+      int n1;
+      int n2 = 0;
 
-  } while (++h < screenH);
+      // Samples carried over are taken as they are, which leaves
+      // any partner to compute on its own
+      if (rowCarry && (rowCarry[w] != FIELD_PENDING || (w2 < screenW && rowCarry[w2] != FIELD_PENDING)))
+      {
+        for (int x = w; x <= w2 && x < screenW; x += colStride)
+        {
+          int n = rowCarry[x];
+          if (n == FIELD_PENDING)
+          {
+            n = doubleDouble ? sampleDoubleDouble(state, x, h, screenW2, screenH2)
+                             : computePixel(single, rowStart + x * localZoom, ci, ciSquared, localLimit);
+            passSum += static_cast<u32>(n);
+            ++samples;
+          }
+          fillBlock(rowField + x, n, rows, std::min(step, screenW - x), screenW);
+        }
+        continue;
+      }
 
-  if (state.process)
-  {
-    state.process = false;
+      if (doubleDouble)
+      {
+        n1 = sampleDoubleDouble(state, w, h, screenW2, screenH2);
+        if (w2 < screenW)
+        {
+          n2 = sampleDoubleDouble(state, w2, h, screenW2, screenH2);
+          fillBlock(rowField + w2, n2, rows, std::min(step, screenW - w2), screenW);
+          ++samples;
+        }
+      }
+      else if (w2 < screenW)
+      {
+        computePair(single, rowStart + w * localZoom, rowStart + w2 * localZoom, ci, ciSquared, localLimit, n1, n2);
+        fillBlock(rowField + w2, n2, rows, std::min(step, screenW - w2), screenW);
+        ++samples;
+      }
+      else
+      {
+        n1 = computePixel(single, rowStart + w * localZoom, ci, ciSquared, localLimit);
+      }
+
+      fillBlock(rowField + w, n1, rows, std::min(step, screenW - w), screenW);
+      passSum += static_cast<u32>(n1 + n2);
+      ++samples;
+    }
   }
+
+  row = screenH;
+  return passSum;
 }
 
 /**
- * Writes a number right aligned into a field exactly width columns wide, or a
- * "999+" style marker when it will not fit. The console is one row tall and
- * text past its last column wraps onto a row that is not there, so every field
- * on the debug strip has to have a width that cannot grow.
+ * Everything the subdivision and tracing engines need while they work, gathered
+ * so each step passes one reference instead of the whole view
  */
-static void fitField(char* out, size_t size, double value, int markerCap, int width, int decimals)
+struct ProbeContext
 {
-  if (snprintf(out, size, "%*.*f", width, decimals, value) > width)
+  bool single;
+  int localLimit;
+  double localZoom;
+  double rowStart;
+  double localCenterY;
+  int screenW;
+  int screenH2;
+  u64 iterSum;
+  u32 computed;
+  u32 filled;
+};
+
+/**
+ * Sets up a context for the view in state and marks every pixel of the field
+ * as not yet computed
+ */
+static void startProbe(ProbeContext& ctx, const MandelbrotState& state, int screenW, int screenH, int screenW2, int screenH2)
+{
+  ctx.single = (fieldTier == PrecisionTier::Float);
+  ctx.localLimit = state.fieldLimit;
+  ctx.localZoom = state.zoom;
+  ctx.rowStart = -screenW2 * state.zoom + state.centerX;
+  ctx.localCenterY = state.centerY;
+  ctx.screenW = screenW;
+  ctx.screenH2 = screenH2;
+  ctx.iterSum = 0;
+  ctx.computed = 0;
+  ctx.filled = 0;
+
+  // Counts carried over are already there to probe, and the
+  // carried field is pending everywhere else
+  FieldCount* top = field + (screenW * FIELD_TOP);
+  if (carryActive)
   {
-    snprintf(out, size, "%*d+", width - 1, markerCap);
+    memcpy(top, carryField + (screenW * FIELD_TOP), sizeof(FieldCount) * screenW * (screenH - FIELD_TOP));
+  }
+  else
+  {
+    std::fill(top, top + (screenW * (screenH - FIELD_TOP)), FIELD_PENDING);
   }
 }
 
 /**
- * Prints the debug strip: frame timings, iteration counts, memory, battery
+ * Returns a pixel's count, iterating it only if nothing has done so yet. Both
+ * engines that use it reach many pixels more than once, and the field's
+ * pending marker is what stops each of them being computed twice
  */
-static void printDebugLine(const MandelbrotState& state, const WPADData* wd, u32 frameMicros)
+static inline int probePixel(ProbeContext& ctx, int x, int y)
 {
-  u32 fps = (frameMicros > 0) ? ((1000000u + (frameMicros >> 1)) / frameMicros) : 0;
-  u32 avgIterPx = (fieldIterPixels > 0) ? static_cast<u32>(fieldIterSum / fieldIterPixels) : 0;
+  FieldCount* px = field + (ctx.screenW * y) + x;
 
-  char fpsText[8];
-  char renderText[12];
-  char freeText[12];
-  fitField(fpsText, sizeof(fpsText), fps, 999, 4, 0);
-  fitField(renderText, sizeof(renderText), lastRenderMicros / 1000.0, 9999, 6, 1);
-  fitField(freeText, sizeof(freeText), SYS_GetArena1Size() / (1024.0 * 1024.0), 999, 5, 1);
+  if (*px == FIELD_PENDING)
+  {
+    const double ci = -1.0 * (y - ctx.screenH2) * ctx.localZoom - ctx.localCenterY;
+    *px = static_cast<FieldCount>(
+      computePixel(ctx.single, ctx.rowStart + x * ctx.localZoom, ci, ci * ci, ctx.localLimit));
+    ctx.iterSum += static_cast<u64>(*px);
+    ++ctx.computed;
+  }
 
-  printf(" FPS:%s RenTime:%sms Iter:%4d AvgIterPx:%4u FreeMem:%sMB Bat:%3u",
-    fpsText, renderText, state.limit, avgIterPx, freeText,
-    static_cast<unsigned>(wd ? wd->battery_level : 0));
+  return *px;
 }
 
 /**
- * Prints the normal strip: view centre, zoom, and the cursor's coordinate
+ * Computes whatever is still missing from one horizontal run of pixels, two at
+ * a time where two neighbours are both missing so the pair kernel can take them
  */
-static void printCoordinateLine(const MandelbrotState& state, const WPADData* wd, int screenW2, int screenH2)
+static void subdivideSpan(ProbeContext& ctx, int y, int x0, int x1)
 {
-  printf(" cX:%.8f cY:%.8f", state.centerX, state.centerY == -0.0 ? 0.0 : -state.centerY);
-  printf("  zoom:%.4e ", INITIAL_ZOOM / state.zoom);
+  FieldCount* rowField = field + (ctx.screenW * y);
+  const double ci = -1.0 * (y - ctx.screenH2) * ctx.localZoom - ctx.localCenterY;
+  const double ciSquared = ci * ci;
 
-  // Display cursor coordinates if IR is valid
-  if (wd && wd->ir.valid)
-  {
-    printf(" re:%.8f im:%.8f",
-      (wd->ir.x - screenW2) * state.zoom + state.centerX,
-      (screenH2 - wd->ir.y) * state.zoom - state.centerY);
-  }
-  else if (wd)
+  int x = x0;
+  while (x <= x1)
   {
-    printf(" No Cursor");
+    if (rowField[x] != FIELD_PENDING)
+    {
+      ++x;
+      continue;
+    }
+
+    if (x < x1 && rowField[x + 1] == FIELD_PENDING)
+    {
+      int n1;
+      int n2;
+      computePair(ctx.single, ctx.rowStart + x * ctx.localZoom, ctx.rowStart + (x + 1) * ctx.localZoom,
+        ci, ciSquared, ctx.localLimit, n1, n2);
+      rowField[x] = static_cast<FieldCount>(n1);
+      rowField[x + 1] = static_cast<FieldCount>(n2);
+      ctx.iterSum += static_cast<u64>(n1 + n2);
+      ctx.computed += 2;
+      x += 2;
+      continue;
+    }
+
+    rowField[x] = static_cast<FieldCount>(
+      computePixel(ctx.single, ctx.rowStart + x * ctx.localZoom, ci, ciSquared, ctx.localLimit));
+    ctx.iterSum += static_cast<u64>(rowField[x]);
+    ++ctx.computed;
+    ++x;
   }
 }
 
 /**
- * Updates the display with coordinate information
+ * Gives the interior of an inclusive rectangle with a uniform border the
+ * border's count. Without a carried field every pixel in there is still
+ * pending. With one, the counts it carried in are real samples, so they are
+ * left alone and not counted as filled, and one that differs from the border
+ * means the rectangle was not uniform after all
+ *
+ * @return False, with nothing filled, when a carried count disagreed
  */
-static void updateDisplay(const MandelbrotState& state, const WPADData* wd, int screenW2, int screenH2)
+static bool fillUniform(ProbeContext& ctx, int x0, int y0, int x1, int y1, int value)
 {
-  // Sampled every frame rather than only in debug mode, so the first frame
-  // after the toggle measures one frame instead of the whole time it was off
-  u64 currentTime = gettime();
-  u32 frameMicros = static_cast<u32>(ticks_to_microsecs(currentTime - lastTime));
-  lastTime = currentTime;
+  if (x1 - x0 <= 1 || y1 - y0 <= 1)
+  {
+    return true;
+  }
 
-  if (state.debugMode)
+  if (!carryActive)
   {
-    printDebugLine(state, wd, frameMicros);
+    fillBlock(field + (ctx.screenW * (y0 + 1)) + x0 + 1, value, y1 - y0 - 1, x1 - x0 - 1, ctx.screenW);
+    ctx.filled += static_cast<u32>((y1 - y0 - 1) * (x1 - x0 - 1));
+    return true;
   }
-  else
+
+  for (int y = y0 + 1; y < y1; ++y)
   {
-    printCoordinateLine(state, wd, screenW2, screenH2);
+    const FieldCount* rowField = field + (ctx.screenW * y);
+    for (int x = x0 + 1; x < x1; ++x)
+    {
+      if (rowField[x] != FIELD_PENDING && rowField[x] != value)
+      {
+        return false;
+      }
+    }
+  }
+
+  for (int y = y0 + 1; y < y1; ++y)
+  {
+    FieldCount* rowField = field + (ctx.screenW * y);
+    for (int x = x0 + 1; x < x1; ++x)
+    {
+      if (rowField[x] == FIELD_PENDING)
+      {
+        rowField[x] = static_cast<FieldCount>(value);
+        ++ctx.filled;
+      }
+    }
   }
+  return true;
 }
 
-static void drawdot(void* xfb, GXRModeObj* rmode, int cx, int cy, u32 color)
+/**
+ * Mariani-Silver subdivision over an inclusive rectangle. When every pixel on
+ * the border has the same count, the set is connected and so is each escape
+ * band, so nothing of another count can sit inside without touching the border
+ * and the interior takes the border's count. Otherwise the rectangle splits
+ * across its longer side and each half tries again
+ */
+static void subdivideRect(ProbeContext& ctx, int x0, int y0, int x1, int y1)
 {
-  u32* fb = static_cast<u32*>(xfb);
-  const int fbWidthHalf = rmode->fbWidth >> 1;
-  const int height = rmode->xfbHeight;
+  if (renderCancel)
+  {
+    return;
+  }
 
-  // Cursor dimensions (approx 5x9 pixels)
-  const int rx = 2;
+  subdivideSpan(ctx, y0, x0, x1);
+  subdivideSpan(ctx, y1, x0, x1);
+
+  const int first = field[(ctx.screenW * y0) + x0];
+  bool uniform = true;
+
+  for (int y = y0 + 1; y < y1; ++y)
+  {
+    // Both sides are computed whatever the outcome, since the halves need them
+    // as their own edges
+    const int left = probePixel(ctx, x0, y);
+    const int right = probePixel(ctx, x1, y);
+    uniform = uniform && left == first && right == first;
+  }
+
+  const FieldCount* topRow = field + (ctx.screenW * y0);
+  const FieldCount* bottomRow = field + (ctx.screenW * y1);
+  for (int x = x0; uniform && x <= x1; ++x)
+  {
+    uniform = topRow[x] == first && bottomRow[x] == first;
+  }
+
+  if (uniform && fillUniform(ctx, x0, y0, x1, y1, first))
+  {
+    return;
+  }
+
+  if (x1 - x0 < SUBDIVIDE_MIN || y1 - y0 < SUBDIVIDE_MIN)
+  {
+    for (int y = y0 + 1; y < y1; ++y)
+    {
+      subdivideSpan(ctx, y, x0 + 1, x1 - 1);
+    }
+    return;
+  }
+
+  // The halves share the dividing line, which each one then sees as an edge
+  if (x1 - x0 >= y1 - y0)
+  {
+    const int mid = (x0 + x1) >> 1;
+    subdivideRect(ctx, x0, y0, mid, y1);
+    subdivideRect(ctx, mid, y0, x1, y1);
+  }
+  else
+  {
+    const int mid = (y0 + y1) >> 1;
+    subdivideRect(ctx, x0, y0, x1, mid);
+    subdivideRect(ctx, x0, mid, x1, y1);
+  }
+}
+
+/**
+ * Renders a whole view with the subdivision engine
+ */
+static void renderSubdivided(const MandelbrotState& state, int screenW, int screenH, int screenW2, int screenH2)
+{
+  ProbeContext ctx;
+  startProbe(ctx, state, screenW, screenH, screenW2, screenH2);
+  subdivideRect(ctx, 0, FIELD_TOP, screenW - 1, screenH - 1);
+
+  fieldIterSum = ctx.iterSum;
+  fieldIterPixels = ctx.computed;
+  fieldFilledPixels = ctx.filled;
+}
+
+/**
+ * Queues a pixel for the tracing engine unless it has been queued before
+ */
+static inline void traceEnqueue(u32& tail, int offset)
+{
+  if (!traceQueued[offset])
+  {
+    traceQueued[offset] = 1;
+    traceQueue[tail++] = static_cast<u32>(offset);
+  }
+}
+
+/**
+ * Renders a whole view by following the edges between regions of equal count.
+ * A pixel whose neighbours all share its count is inside a region and needs
+ * nothing more. One that differs from a neighbour is on an edge, so its
+ * neighbours are queued and the edge is followed from there. Once every edge
+ * is closed, each region is filled from the pixels along its outline, so a
+ * region costs its perimeter rather than its area
+ *
+ * @return False when the work buffers could not be allocated
+ */
+static bool renderTraced(const MandelbrotState& state, int screenW, int screenH, int screenW2, int screenH2)
+{
+  const size_t pixels = static_cast<size_t>(screenW) * screenH;
+
+  if (!traceQueue)
+  {
+    traceQueue = static_cast<u32*>(aligned_alloc(32, ALIGN32(sizeof(u32) * pixels)));
+    traceQueued = static_cast<uint8_t*>(aligned_alloc(32, ALIGN32(pixels)));
+    if (!traceQueue || !traceQueued)
+    {
+      free(traceQueue);
+      free(traceQueued);
+      traceQueue = nullptr;
+      traceQueued = nullptr;
+      return false;
+    }
+  }
+
+  ProbeContext ctx;
+  startProbe(ctx, state, screenW, screenH, screenW2, screenH2);
+  std::fill(traceQueued, traceQueued + pixels, 0);
+
+  const int top = screenW * FIELD_TOP;
+  const int bottom = screenW * (screenH - 1);
+  u32 head = 0;
+  u32 tail = 0;
+
+  // Nothing outside the screen can close an edge, so every region starts out
+  // bounded by the screen's own border
+  for (int x = 0; x < screenW; ++x)
+  {
+    traceEnqueue(tail, top + x);
+    traceEnqueue(tail, bottom + x);
+  }
+  for (int offset = top + screenW; offset < bottom; offset += screenW)
+  {
+    traceEnqueue(tail, offset);
+    traceEnqueue(tail, offset + screenW - 1);
+  }
+
+  while (head != tail && !renderCancel)
+  {
+    const int offset = static_cast<int>(traceQueue[head++]);
+    const int x = offset % screenW;
+    const int y = offset / screenW;
+    const int center = probePixel(ctx, x, y);
+
+    const bool hasLeft = x > 0;
+    const bool hasRight = x < screenW - 1;
+    const bool hasUp = y > FIELD_TOP;
+    const bool hasDown = y < screenH - 1;
+
+    const bool left = hasLeft && probePixel(ctx, x - 1, y) != center;
+    const bool right = hasRight && probePixel(ctx, x + 1, y) != center;
+    const bool up = hasUp && probePixel(ctx, x, y - 1) != center;
+    const bool down = hasDown && probePixel(ctx, x, y + 1) != center;
+
+    if (left)
+    {
+      traceEnqueue(tail, offset - 1);
+    }
+    if (right)
+    {
+      traceEnqueue(tail, offset + 1);
+    }
+    if (up)
+    {
+      traceEnqueue(tail, offset - screenW);
+    }
+    if (down)
+    {
+      traceEnqueue(tail, offset + screenW);
+    }
+
+    // An edge can also turn a corner, which only the diagonal sees
+    if (hasUp && hasLeft && (up || left))
+    {
+      traceEnqueue(tail, offset - screenW - 1);
+    }
+    if (hasUp && hasRight && (up || right))
+    {
+      traceEnqueue(tail, offset - screenW + 1);
+    }
+    if (hasDown && hasLeft && (down || left))
+    {
+      traceEnqueue(tail, offset + screenW - 1);
+    }
+    if (hasDown && hasRight && (down || right))
+    {
+      traceEnqueue(tail, offset + screenW + 1);
+    }
+  }
+
+  // Every unprobed pixel is inside a closed region, and the left column was
+  // probed as part of the border, so each one can take the count to its left
+  u32 filled = 0;
+  for (int offset = top; offset <= bottom; offset += screenW)
+  {
+    FieldCount* rowField = field + offset;
+    for (int x = 1; x < screenW; ++x)
+    {
+      if (rowField[x] == FIELD_PENDING)
+      {
+        rowField[x] = rowField[x - 1];
+        ++filled;
+      }
+    }
+  }
+
+  fieldIterSum = ctx.iterSum;
+  fieldIterPixels = ctx.computed;
+  fieldFilledPixels = filled;
+  return true;
+}
+
+/**
+ * Renders the current view again with the row engine and counts the pixels
+ * where the field disagrees with it. Only run on request from the debug strip,
+ * since it costs a full render and a second field. Rows the row engine copies
+ * across the real axis stand for a point up to half a pixel away, so neither
+ * engine's count there says anything about the other's, and they are skipped
+ *
+ * @return Number of differing pixels, or -1 if there was no memory to compare
+ */
+static int compareWithRowEngine(const MandelbrotState& state, int screenW, int screenH, int screenW2, int screenH2)
+{
+  FieldCount* reference = static_cast<FieldCount*>(aligned_alloc(32, ALIGN32(sizeof(FieldCount) * screenW)));
+  if (!reference)
+  {
+    return -1;
+  }
+
+  // The check's own pixels would otherwise count against the field
+  const KernelExits fieldExits = kernelExits;
+  const double rowStart = -screenW2 * state.zoom + state.centerX;
+  bool mirrorExact;
+  const int mirrorSum = mirrorBase(state.centerY, state.zoom, screenH2, mirrorExact);
+  int mismatches = 0;
+
+  for (int h = FIELD_TOP; h < screenH && !renderCancel; ++h)
+  {
+    const int mirror = mirrorSum - h;
+    if (mirror >= FIELD_TOP && mirror < h)
+    {
+      continue;
+    }
+
+    const double ci = -1.0 * (h - screenH2) * state.zoom - state.centerY;
+    RenderRow(reference, screenW, rowStart, state.zoom, ci, state.fieldLimit, fieldTier == PrecisionTier::Float);
+
+    const FieldCount* rowField = field + (screenW * h);
+    for (int w = 0; w < screenW; ++w)
+    {
+      mismatches += (rowField[w] != reference[w]) ? 1 : 0;
+    }
+  }
+
+  free(reference);
+  kernelExits = fieldExits;
+  return mismatches;
+}
+
+/**
+ * Renders a whole view by perturbation around the full precision centre
+ *
+ * @return False when there was no memory for the reference orbit
+ */
+static bool renderDeep(const MandelbrotState& state, int screenW, int screenH, int screenW2, int screenH2)
+{
+  DeepView view;
+  view.centerRe = state.preciseX;
+  // The field's rows run down the screen while the imaginary axis runs up, so
+  // the centre's imaginary part is the negation of centerY
+  view.centerIm = BigFixedNegate(state.preciseY);
+  view.zoom = state.zoom;
+  view.limit = state.fieldLimit;
+  view.width = screenW;
+  view.top = FIELD_TOP;
+  view.height = screenH;
+  view.centerCol = screenW2;
+  view.centerRow = screenH2;
+  view.cancel = &renderCancel;
+
+  if (!RenderDeepField(view, field, deepStats))
+  {
+    return false;
+  }
+
+  fieldIterSum = deepStats.iterSum;
+  fieldIterPixels = deepStats.computed;
+  return true;
+}
+
+/**
+ * Allocates the carried field the first time a render carries counts over
+ *
+ * @return False when there is no memory for it
+ */
+static bool reserveCarryField(int screenW, int screenH)
+{
+  if (!carryField)
+  {
+    carryField = static_cast<FieldCount*>(aligned_alloc(32, ALIGN32(sizeof(FieldCount) * screenW * screenH)));
+  }
+  return carryField != nullptr;
+}
+
+/**
+ * Sets aside a finished field's counts for the same view at a higher limit. A
+ * pixel that escaped short of the old limit escapes at the same count at any
+ * higher one, so only the pixels that reached it are left pending
+ *
+ * @return How many counts were kept, 0 as well when there was no memory
+ */
+static u32 raiseCarried(int localLimit, int screenW, int screenH)
+{
+  if (!reserveCarryField(screenW, screenH))
+  {
+    return 0;
+  }
+
+  const FieldCount* px = field + (screenW * FIELD_TOP);
+  const FieldCount* end = field + (screenW * screenH);
+  FieldCount* rowCarry = carryField + (screenW * FIELD_TOP);
+  u32 kept = 0;
+  for (; px < end; ++px, ++rowCarry)
+  {
+    const bool escaped = (*px < localLimit);
+    *rowCarry = escaped ? *px : FIELD_PENDING;
+    kept += escaped;
+  }
+
+  return kept;
+}
+
+/**
+ * Builds the escape-count histogram of a finished field and, with the limit on
+ * automatic, moves the limit one step along the ladder the 1 and 2 buttons
+ * use. Raising renders the view again at once, since pixels stuck at the limit
+ * may be boundary, but carries over every count that escaped short of it.
+ * Lowering waits for the next view
+ */
+static void updateAutoLimit(MandelbrotState& state, int screenW, int screenH)
+{
+  const int localLimit = state.fieldLimit;
+  std::fill(limitHistogram, limitHistogram + HISTOGRAM_BINS, 0u);
+  fieldInterior = 0;
+
+  const FieldCount* px = field + (screenW * FIELD_TOP);
+  const FieldCount* end = field + (screenW * screenH);
+  for (; px < end; ++px)
+  {
+    const int n = *px;
+    if (n >= localLimit)
+    {
+      ++fieldInterior;
+    }
+    else
+    {
+      ++limitHistogram[(n * HISTOGRAM_BINS) / localLimit];
+    }
+  }
+
+  if (!state.autoLimit)
+  {
+    return;
+  }
+
+  // A bin holds counts from b / HISTOGRAM_BINS of the limit up, so these are
+  // the escaped pixels at or past a quarter and half of it
+  u32 escaped = 0;
+  u32 pastQuarter = 0;
+  u32 pastHalf = 0;
+  for (int b = 0; b < HISTOGRAM_BINS; ++b)
+  {
+    escaped += limitHistogram[b];
+    pastQuarter += (b >= HISTOGRAM_BINS / 4) ? limitHistogram[b] : 0;
+    pastHalf += (b >= HISTOGRAM_BINS / 2) ? limitHistogram[b] : 0;
+  }
+
+  const u32 tail = std::max(escaped / AUTO_LIMIT_TAIL, AUTO_LIMIT_STRAYS);
+  if (pastHalf > tail && localLimit < LIMIT_MAX)
+  {
+    const int doubled = localLimit << 1;
+    state.limit = (doubled < LIMIT_MAX) ? doubled : LIMIT_MAX;
+    state.nextLimit = 0;
+    state.process = true;
+
+    // Perturbation takes its pixels from a reference orbit, not one by one
+    state.carryRaised = (fieldTier != PrecisionTier::Perturbation) ? raiseCarried(localLimit, screenW, screenH) : 0;
+    state.carryZoom = (state.carryRaised > 0) ? state.zoom : 0;
+    state.carryX = state.centerX;
+    state.carryY = state.centerY;
+  }
+  else if (pastQuarter <= tail && localLimit > AUTO_LIMIT_MIN)
+  {
+    state.nextLimit = std::max(localLimit >> 1, AUTO_LIMIT_MIN);
+  }
+}
+
+/**
+ * Computes columns x0 to x1 of one row in the tier the field was drawn in,
+ * pairing neighbours for the pair kernel like RenderRow does
+ *
+ * @return Total iteration count across the span
+ */
+static u32 renderSpan(const MandelbrotState& state, int h, int x0, int x1, int screenW, int screenW2, int screenH2)
+{
+  FieldCount* rowField = field + (screenW * h);
+  const int localLimit = state.fieldLimit;
+  const double localZoom = state.zoom;
+  u32 spanSum = 0;
+
+  if (fieldTier == PrecisionTier::DoubleDouble)
+  {
+    for (int w = x0; w < x1; ++w)
+    {
+      rowField[w] = static_cast<FieldCount>(sampleDoubleDouble(state, w, h, screenW2, screenH2));
+      spanSum += static_cast<u32>(rowField[w]);
+    }
+    return spanSum;
+  }
+
+  const bool single = (fieldTier == PrecisionTier::Float);
+  const double rowStart = -screenW2 * localZoom + state.centerX;
+  const double ci = -1.0 * (h - screenH2) * localZoom - state.centerY;
+  const double ciSquared = ci * ci;
+  int w = x0;
+  for (; w + 1 < x1; w += 2)
+  {
+    int n1;
+    int n2;
+    computePair(single, rowStart + w * localZoom, rowStart + (w + 1) * localZoom, ci, ciSquared, localLimit, n1, n2);
+    rowField[w] = static_cast<FieldCount>(n1);
+    rowField[w + 1] = static_cast<FieldCount>(n2);
+    spanSum += static_cast<u32>(n1 + n2);
+  }
+  if (w < x1)
+  {
+    rowField[w] = static_cast<FieldCount>(computePixel(single, rowStart + w * localZoom, ci, ciSquared, localLimit));
+    spanSum += static_cast<u32>(rowField[w]);
+  }
+
+  return spanSum;
+}
+
+/**
+ * Moves the field by whole pixels in place, leaving what the move uncovered
+ * holding what it did before
+ */
+static void shiftField(int dx, int dy, int screenW, int screenH)
+{
+  const int keepCols = screenW - std::abs(dx);
+  const int fromCol = std::max(-dx, 0);
+  const int toCol = std::max(dx, 0);
+
+  // Rows move away from the edge the picture is dragged towards, so walk
+  // from that edge to read every row before it is overwritten
+  if (dy > 0)
+  {
+    for (int h = screenH - 1; h >= FIELD_TOP + dy; --h)
+    {
+      memmove(field + (screenW * h) + toCol, field + (screenW * (h - dy)) + fromCol, sizeof(FieldCount) * keepCols);
+    }
+  }
+  else
+  {
+    for (int h = FIELD_TOP; h < screenH + dy; ++h)
+    {
+      memmove(field + (screenW * h) + toCol, field + (screenW * (h - dy)) + fromCol, sizeof(FieldCount) * keepCols);
+    }
+  }
+}
+
+/**
+ * Moves a finished field by whole pixels in place and computes only what the
+ * move uncovered: a band of rows along the top or bottom edge, and a band of
+ * columns down the side for the rows in between
+ *
+ * @return Pixels computed
+ */
+static u32 panField(const MandelbrotState& state, int dx, int dy, int screenW, int screenH, int screenW2, int screenH2)
+{
+  shiftField(dx, dy, screenW, screenH);
+
+  const int keepCols = screenW - std::abs(dx);
+  const int bandTop = (dy > 0) ? FIELD_TOP : screenH + dy;
+  const int bandBottom = (dy > 0) ? FIELD_TOP + dy : screenH;
+  const int colStart = (dx > 0) ? 0 : keepCols;
+  u32 pixels = 0;
+
+  for (int h = FIELD_TOP; h < screenH; ++h)
+  {
+    if (h >= bandTop && h < bandBottom)
+    {
+      fieldIterSum += renderSpan(state, h, 0, screenW, screenW, screenW2, screenH2);
+      pixels += static_cast<u32>(screenW);
+    }
+    else if (dx != 0)
+    {
+      fieldIterSum += renderSpan(state, h, colStart, colStart + std::abs(dx), screenW, screenW2, screenH2);
+      pixels += static_cast<u32>(std::abs(dx));
+    }
+  }
+
+  fieldIterPixels += pixels;
+  return pixels;
+}
+
+/**
+ * Moves a field the progressive passes are still refining, whose lattice at
+ * step is complete, and samples what the move uncovered on that lattice. The
+ * lattice moves with the picture, so every sample left on screen is still one.
+ * A block the uncovered edge cuts through keeps the sample it has, or computes
+ * it where the sample itself was uncovered or lies off the field
+ *
+ * @return Samples computed
+ */
+static u32 panLattice(
+  MandelbrotState& state,
+  int dx,
+  int dy,
+  int step,
+  int screenW,
+  int screenH,
+  int screenW2,
+  int screenH2)
+{
+  shiftField(dx, dy, screenW, screenH);
+  state.latticeCol = (state.latticeCol + dx) & (step - 1);
+  state.latticeRow = (state.latticeRow + dy) & (step - 1);
+
+  const int bandTop = (dy > 0) ? FIELD_TOP : screenH + dy;
+  const int bandBottom = (dy > 0) ? FIELD_TOP + dy : screenH;
+  const int colStart = (dx > 0) ? 0 : screenW + dx;
+  const int colEnd = colStart + std::abs(dx);
+  const int firstCol = state.latticeCol - step;
+  const double rowStart = -screenW2 * state.zoom + state.centerX;
+  const bool single = (fieldTier == PrecisionTier::Float);
+  u32 samples = 0;
+
+  // Blocks start a step before the field's first row and column, so the
+  // lattice's partial blocks along the top and left edges are covered too
+  for (int h = FIELD_TOP + state.latticeRow - step; h < screenH; h += step)
+  {
+    const int y0 = std::max(h, FIELD_TOP);
+    const int y1 = std::min(h + step, screenH);
+    const bool inBand = (y0 < bandBottom && y1 > bandTop);
+    if (y0 >= y1 || (!inBand && dx == 0))
+    {
+      continue;
+    }
+
+    const int wStart = inBand ? firstCol : firstCol + ((colStart - firstCol) / step) * step;
+    const int wEnd = inBand ? screenW : colEnd;
+    const double ci = -1.0 * (h - screenH2) * state.zoom - state.centerY;
+    for (int w = wStart; w < wEnd; w += step)
+    {
+      const int x0 = std::max(w, 0);
+      const int x1 = std::min(w + step, screenW);
+      if (x0 >= x1)
+      {
+        continue;
+      }
+
+      const bool kept = (h == y0 && w == x0 && (h < bandTop || h >= bandBottom) && (w < colStart || w >= colEnd));
+      int n;
+      if (kept)
+      {
+        n = field[(screenW * h) + w];
+      }
+      else
+      {
+        n = (fieldTier == PrecisionTier::DoubleDouble) ? sampleDoubleDouble(state, w, h, screenW2, screenH2)
+          : computePixel(single, rowStart + w * state.zoom, ci, ci * ci, state.fieldLimit);
+        fieldIterSum += static_cast<u32>(n);
+        ++samples;
+      }
+
+      // Only the uncovered pixels of the block are written
+      for (int y = y0; y < y1; ++y)
+      {
+        const bool rowUncovered = (y >= bandTop && y < bandBottom);
+        const int fillFrom = rowUncovered ? x0 : std::max(x0, colStart);
+        const int fillTo = rowUncovered ? x1 : std::min(x1, colEnd);
+        FieldCount* rowField = field + (screenW * y);
+        for (int x = fillFrom; x < fillTo; ++x)
+        {
+          rowField[x] = static_cast<FieldCount>(n);
+        }
+      }
+    }
+  }
+
+  fieldIterPixels += samples;
+  return samples;
+}
+
+/**
+ * Sets aside the counts a grid zoom keeps from the field it zoomed from. New
+ * pixel (x, y) an even number of pixels across and down from the centre is
+ * old pixel (carryCol + (x - screenW2) / 2, carryRow + (y - screenH2) / 2),
+ * which is kept unless it fell outside the old field or on a row copied
+ * across the axis only to within half a pixel
+ *
+ * @return How many counts were kept, 0 as well when there was no memory
+ */
+static u32 gatherCarried(const MandelbrotState& state, int screenW, int screenH, int screenW2, int screenH2)
+{
+  if (!reserveCarryField(screenW, screenH))
+  {
+    return 0;
+  }
+
+  FieldCount* top = carryField + (screenW * FIELD_TOP);
+  std::fill(top, top + (screenW * (screenH - FIELD_TOP)), FIELD_PENDING);
+  u32 kept = 0;
+
+  for (int y = FIELD_TOP + ((screenH2 - FIELD_TOP) & 1); y < screenH; y += 2)
+  {
+    const int oldRow = state.carryRow + (y - screenH2) / 2;
+    const int mirror = state.carryMirror - oldRow;
+    if (oldRow < FIELD_TOP || oldRow >= screenH || (mirror >= FIELD_TOP && mirror < oldRow))
+    {
+      continue;
+    }
+
+    const FieldCount* oldField = field + (screenW * oldRow);
+    FieldCount* rowCarry = carryField + (screenW * y);
+    for (int x = screenW2 & 1; x < screenW; x += 2)
+    {
+      const int oldCol = state.carryCol + (x - screenW2) / 2;
+      if (oldCol >= 0 && oldCol < screenW)
+      {
+        rowCarry[x] = oldField[oldCol];
+        ++kept;
+      }
+    }
+  }
+
+  return kept;
+}
+
+/**
+ * The view as the field cache keys it, with the totals of the field on screen
+ */
+static FieldFileView cacheView(const MandelbrotState& state, int screenW, int screenH)
+{
+  FieldFileView view;
+  view.centerX = state.preciseX;
+  view.centerY = state.preciseY;
+  view.zoom = state.zoom;
+  view.limit = state.limit;
+  view.width = screenW;
+  view.top = FIELD_TOP;
+  view.height = screenH;
+  view.iterSum = fieldIterSum;
+  view.iterPixels = fieldIterPixels;
+  return view;
+}
+
+/**
+ * Loads the view's field from the cache in place of rendering it. With the
+ * limit on automatic whatever limit the view was saved at will do, since
+ * only a limit the histogram had settled on was saved
+ *
+ * @return True on a hit, with the field complete
+ */
+static bool loadCachedField(MandelbrotState& state, int screenW, int screenH)
+{
+  FieldFileView view = cacheView(state, screenW, screenH);
+  if (state.cacheSkip)
+  {
+    state.cacheSkip = false;
+    return false;
+  }
+
+  if (!FieldCacheLoad(view, state.autoLimit, field))
+  {
+    return false;
+  }
+
+  state.limit = view.limit;
+  state.fieldLimit = view.limit;
+  state.degraded = false;
+  state.refineStep = 0;
+  state.refineRow = FIELD_TOP;
+  state.cachePending = false;
+  fieldIterSum = view.iterSum;
+  fieldIterPixels = view.iterPixels;
+  kernelExits = {0, 0, 0, 0, 0};
+  fieldFilledPixels = 0;
+  fieldCarriedPixels = 0;
+  carryActive = false;
+  fieldMismatches = -1;
+  fieldPanPixels = -1;
+  fieldTier = state.precisionTier();
+  fieldEngineName = "Cache";
+  return true;
+}
+
+/**
+ * Saves a finished field to the cache once input has stopped, since the card
+ * takes a while to write it, or at once when it is to be bookmarked. Runs on
+ * the render thread when there is one
+ */
+static void storeCachedField(MandelbrotState& state, RenderJob& job, int screenW, int screenH)
+{
+  if (state.refineStep != 0 || state.process || state.degraded || renderCancel)
+  {
+    return;
+  }
+
+  const bool mark = job.markRequested && !job.markServed;
+  const FieldFileView view = cacheView(state, screenW, screenH);
+  if (state.cachePending && (mark || !job.interacting))
+  {
+    // Tried once a field, card or no card
+    FieldCacheStore(view, field);
+    state.cachePending = false;
+  }
+
+  if (mark)
+  {
+    FieldCacheMark(view);
+    job.markServed = true;
+  }
+}
+
+/**
+ * Brings the field up to date with the view: the whole of it for a new view,
+ * or the next pass of a progressive one. While input continues the governor
+ * level decides how much of that a frame may do
+ *
+ * @return True when any count in the field changed
+ */
+static bool computeField(
+  MandelbrotState& state,
+  const RenderJob& job,
+  int screenW,
+  int screenH,
+  int screenW2,
+  int screenH2)
+{
+  // Cache state variables locally to allow the compiler to use registers
+  const double localZoom = state.zoom;
+  const double localCenterX = state.centerX;
+  const double localCenterY = state.centerY;
+  const bool interacting = job.interacting;
+  const GovernorLevel& governor = GovernorLevels[interacting ? governorLevel : 0];
+  const int finestStep = interacting ? std::max(governor.finestStep, INTERACTIVE_STEP) : 1;
+
+  // A field the governor cut short is drawn again properly once input stops
+  if (!interacting && state.degraded)
+  {
+    state.process = true;
+  }
+
+  // A field in the tier the view still needs can be shifted, finished or not.
+  // One still refining has its edges sampled on the lattice of the last
+  // complete pass, and a pass part done starts again over the moved field.
+  // Anything else, or a move past a whole screen, starts over
+  bool panned = false;
+  if (state.panX != 0 || state.panY != 0)
+  {
+    if (!state.process && fieldTier != PrecisionTier::Perturbation && fieldTier == state.precisionTier()
+      && std::abs(state.panX) < screenW && std::abs(state.panY) < screenH - FIELD_TOP)
+    {
+      if (state.refineStep == 0)
+      {
+        fieldPanPixels = static_cast<int>(panField(state, state.panX, state.panY, screenW, screenH, screenW2, screenH2));
+      }
+      else
+      {
+        fieldPanPixels = static_cast<int>(panLattice(state, state.panX, state.panY, state.refineStep << 1,
+          screenW, screenH, screenW2, screenH2));
+        state.refineRow = FIELD_TOP;
+      }
+
+      // Carried counts and a check belong to where the field was
+      carryActive = false;
+      fieldMismatches = -1;
+      panned = true;
+      state.cachePending = true;
+    }
+    else
+    {
+      state.process = true;
+    }
+    state.panX = 0;
+    state.panY = 0;
+  }
+
+  const bool localProcess = state.process;
+  bool rowEngine = (state.engine == RenderEngine::Rows);
+
+  // Only the first render of the view a grid zoom went to can carry counts
+  // over, whatever becomes of it
+  const bool carry = localProcess && state.carryReady();
+  if (localProcess)
+  {
+    state.carryZoom = 0;
+  }
+  bool progressive = job.progressive;
+  const u64 computeStart = gettime();
+
+  if (localProcess && state.autoLimit && state.nextLimit > 0)
+  {
+    state.limit = state.nextLimit;
+    state.nextLimit = 0;
+  }
+
+  // A view saved before is read back whole, and only the histogram is left
+  // to build
+  if (localProcess && loadCachedField(state, screenW, screenH))
+  {
+    state.process = false;
+    tierRenderMicros[static_cast<int>(fieldTier)] = static_cast<u32>(ticks_to_microsecs(gettime() - computeStart));
+    updateAutoLimit(state, screenW, screenH);
+
+    // A field saved with the limit set by hand can be one the histogram
+    // raises, and loading it again would only raise it again
+    state.cacheSkip = state.process;
+    return true;
+  }
+
+  if (localProcess)
+  {
+    const PrecisionTier carryTier = fieldTier;
+    const int carryLimit = state.fieldLimit;
+    state.cachePending = true;
+    fieldIterSum = 0;
+    fieldIterPixels = 0;
+    kernelExits = {0, 0, 0, 0, 0};
+    fieldFilledPixels = 0;
+    fieldMismatches = -1;
+    fieldPanPixels = -1;
+    fieldTier = state.precisionTier();
+    fieldEngineName = RenderEngineNames[0];
+    tierRenderMicros[static_cast<int>(fieldTier)] = 0;
+    state.fieldLimit = std::max(1, state.limit >> governor.limitShift);
+    state.degraded = (state.fieldLimit != state.limit);
+
+    // Carried counts have to come from the same arithmetic at the same limit,
+    // or for a raised limit at a higher one than they escaped short of.
+    // Perturbation takes its pixels from a reference orbit, not one by one
+    fieldCarriedPixels = 0;
+    if (carry && fieldTier == carryTier && fieldTier != PrecisionTier::Perturbation)
+    {
+      if (state.carryRaised > 0 && state.fieldLimit > carryLimit)
+      {
+        fieldCarriedPixels = state.carryRaised;
+      }
+      else if (state.carryRaised == 0 && state.fieldLimit == carryLimit)
+      {
+        fieldCarriedPixels = gatherCarried(state, screenW, screenH, screenW2, screenH2);
+      }
+    }
+    carryActive = (fieldCarriedPixels > 0);
+
+    // Rows asked for in one go still go progressive while input continues, so
+    // quick zooms cost a reduced resolution view each. Once the view settles
+    // the passes carry on to the same field a single pass would have made
+    if (interacting && rowEngine)
+    {
+      progressive = true;
+    }
+
+    // Past level 0 only progressive rows can be split across frames, so they
+    // stand in for the other engines until input stops
+    if (interacting && governorLevel > 0 && fieldTier != PrecisionTier::Perturbation && !rowEngine)
+    {
+      rowEngine = true;
+      progressive = true;
+      state.degraded = true;
+    }
+
+    // Without its work buffers the tracing engine hands the view to the rows,
+    // and so does the deep renderer, which at least shows the view blocky.
+    // The double-double tier only ever renders in rows
+    bool rendered = false;
+    if (fieldTier == PrecisionTier::Perturbation)
+    {
+      rendered = renderDeep(state, screenW, screenH, screenW2, screenH2);
+      fieldEngineName = rendered ? "Deep" : fieldEngineName;
+      fieldTier = rendered ? fieldTier : PrecisionTier::Double;
+    }
+    else if (!rowEngine && runsEveryEngine(fieldTier) && state.engine == RenderEngine::Subdivide)
+    {
+      renderSubdivided(state, screenW, screenH, screenW2, screenH2);
+      rendered = true;
+    }
+    else if (!rowEngine && runsEveryEngine(fieldTier) && state.engine == RenderEngine::Trace)
+    {
+      rendered = renderTraced(state, screenW, screenH, screenW2, screenH2);
+    }
+
+    if (rendered && runsEveryEngine(fieldTier))
+    {
+      fieldEngineName = RenderEngineNames[static_cast<int>(state.engine)];
+    }
+
+    rowEngine = !rendered;
+    state.refineStep = (rowEngine && progressive) ? governor.coarseStep : 0;
+    state.refineRow = FIELD_TOP;
+    state.latticeCol = 0;
+    state.latticeRow = 0;
+  }
+
+  // A progressive render computes one pass per frame and lets the frame
+  // present it, so the view sharpens in place and input is read between passes.
+  // While input continues a pass may take several frames, and passes finer than
+  // the interactive resolution or the governor allow wait for it to stop
+  const bool refining = state.refineStep >= finestStep;
+  if (refining)
+  {
+    const bool firstPass = (state.refineRow == FIELD_TOP) && localProcess;
+    const u64 deadline = (interacting && !firstPass) ? computeStart + microsecs_to_ticks(RENDER_BUDGET_MICROS) : 0;
+    u32 samples;
+    fieldIterSum += renderRefinePass(state, state.refineStep, firstPass, state.refineRow, deadline,
+      screenW, screenH, screenW2, screenH2, samples);
+    fieldIterPixels += samples;
+
+    if (state.refineRow >= screenH)
+    {
+      state.refineStep >>= 1;
+      state.refineRow = FIELD_TOP;
+    }
+  }
+
+  if (localProcess && rowEngine && !progressive)
+  {
+    bool mirrorExact;
+    const int mirrorSum = mirrorBase(state.centerY, state.zoom, screenH2, mirrorExact);
+
+    for (int h = FIELD_TOP; h < screenH && !renderCancel; ++h)
+    {
+      FieldCount* rowField = field + (screenW * h);
+
+      // The set is symmetric about the real axis, so a row mirroring one
+      // already computed is a copy of it
+      const int mirror = mirrorSum - h;
+      if (mirror >= FIELD_TOP && mirror < h)
+      {
+        memcpy(rowField, field + (screenW * mirror), sizeof(FieldCount) * screenW);
+        fieldFilledPixels += static_cast<u32>(screenW);
+        continue;
+      }
+
+      if (carryActive)
+      {
+        u32 samples;
+        fieldIterSum += renderRowCarried(state, rowField, carryField + (screenW * h), h, screenW, screenW2, screenH2,
+          samples);
+        fieldIterPixels += samples;
+        continue;
+      }
+
+      if (fieldTier == PrecisionTier::DoubleDouble)
+      {
+        fieldIterSum += renderRowDD(state, rowField, h, screenW, screenW2, screenH2);
+      }
+      else
+      {
+        double ci = -1.0 * (h - screenH2) * localZoom - localCenterY;
+        fieldIterSum += RenderRow(rowField, screenW, -screenW2 * localZoom + localCenterX, localZoom, ci, state.fieldLimit,
+          fieldTier == PrecisionTier::Float);
+      }
+      fieldIterPixels += static_cast<u32>(screenW);
+    }
+  }
+
+  // A job cancelled while starting the view leaves it part drawn, so the view
+  // starts over. A later pass stopped at refineRow with the rows above it done
+  // and the rest still holding the pass before, so the next job picks it up
+  // there, and a job that had nothing left to do has lost nothing
+  if (renderCancel)
+  {
+    const bool resumes = refining && !localProcess;
+    if (localProcess)
+    {
+      state.process = true;
+    }
+    else if (resumes)
+    {
+      tierRenderMicros[static_cast<int>(fieldTier)] += static_cast<u32>(ticks_to_microsecs(gettime() - computeStart));
+    }
+    return resumes || panned;
+  }
+
+  if (localProcess || refining)
+  {
+    tierRenderMicros[static_cast<int>(fieldTier)] += static_cast<u32>(ticks_to_microsecs(gettime() - computeStart));
+  }
+
+  if (state.process)
+  {
+    state.process = false;
+  }
+
+  if ((localProcess || refining) && state.refineStep == 0 && !state.degraded)
+  {
+    updateAutoLimit(state, screenW, screenH);
+  }
+
+  return localProcess || refining || panned;
+}
+
+/**
+ * Computes one sample at a fractional pixel position in the tier that drew
+ * the field, landing on the pixel's own point at whole positions
+ */
+static inline int sampleSubPixel(const MandelbrotState& state, double x, double y, int screenW2, int screenH2)
+{
+  if (fieldTier == PrecisionTier::DoubleDouble)
+  {
+    const DoubleDouble cr = ddAdd(state.ddCenterX, {(x - screenW2) * state.zoom, 0});
+    const DoubleDouble ci = ddSub({-1.0 * (y - screenH2) * state.zoom, 0}, state.ddCenterY);
+    return computeMandelbrotIterationDD(cr, ci, state.fieldLimit);
+  }
+
+  const double cr = -screenW2 * state.zoom + state.centerX + x * state.zoom;
+  const double ci = -1.0 * (y - screenH2) * state.zoom - state.centerY;
+  return computePixel(fieldTier == PrecisionTier::Float, cr, ci, ci * ci, state.fieldLimit);
+}
+
+/**
+ * Samples one edge pixel. Four samples on a 2x2 grid come first, which is
+ * what 4x supersampling takes of every pixel, and four more on a grid turned
+ * against it follow when those four straddle the edge of the set itself,
+ * where black meets colour and a quarter of the pixel shows the most
+ */
+static void sampleEdge(const MandelbrotState& state, FieldEdge& edge, int screenW, int screenW2, int screenH2)
+{
+  static constexpr double Grid[EDGE_SAMPLES][2] = {
+    {-0.25, -0.25}, {0.25, -0.25}, {-0.25, 0.25}, {0.25, 0.25},
+    {-0.125, -0.375}, {0.375, -0.125}, {0.125, 0.375}, {-0.375, 0.125}};
+
+  const int x = static_cast<int>(edge.offset % screenW);
+  const int y = static_cast<int>(edge.offset / screenW);
+  const int limit = state.fieldLimit;
+  int inside = 0;
+
+  // The first four lie in two rows, which the pair kernel takes two at a time
+  for (int i = 0; i < 4; i += 2)
+  {
+    int n1;
+    int n2;
+    if (fieldTier == PrecisionTier::DoubleDouble)
+    {
+      n1 = sampleSubPixel(state, x + Grid[i][0], y + Grid[i][1], screenW2, screenH2);
+      n2 = sampleSubPixel(state, x + Grid[i + 1][0], y + Grid[i][1], screenW2, screenH2);
+    }
+    else
+    {
+      const double rowStart = -screenW2 * state.zoom + state.centerX;
+      const double ci = -1.0 * (y + Grid[i][1] - screenH2) * state.zoom - state.centerY;
+      computePair(fieldTier == PrecisionTier::Float, rowStart + (x + Grid[i][0]) * state.zoom,
+        rowStart + (x + Grid[i + 1][0]) * state.zoom, ci, ci * ci, limit, n1, n2);
+    }
+    edge.counts[i] = static_cast<FieldCount>(n1);
+    edge.counts[i + 1] = static_cast<FieldCount>(n2);
+    inside += ((n1 >= limit) ? 1 : 0) + ((n2 >= limit) ? 1 : 0);
+  }
+  edge.samples = 4;
+
+  if (inside == 0 || inside == 4)
+  {
+    return;
+  }
+
+  for (int i = 4; i < EDGE_SAMPLES; ++i)
+  {
+    edge.counts[i] = static_cast<FieldCount>(sampleSubPixel(state, x + Grid[i][0], y + Grid[i][1], screenW2, screenH2));
+  }
+  edge.samples = EDGE_SAMPLES;
+}
+
+/**
+ * Antialiases a finished field a step at a time: finds its edges, then samples
+ * them one after another until the list is done or the job is cancelled. Flat
+ * areas are passed over whole, so the cost follows the length of the edges.
+ * Perturbation fields are left alone, since their pixels only come from the
+ * reference orbit
+ */
+static void antialiasField(const MandelbrotState& state, int screenW, int screenH, int screenW2, int screenH2)
+{
+  if (fieldTier == PrecisionTier::Perturbation)
+  {
+    return;
+  }
+
+  if (!fieldEdges)
+  {
+    fieldEdges = static_cast<FieldEdge*>(aligned_alloc(32, ALIGN32(sizeof(FieldEdge) * EDGE_CAPACITY)));
+    if (!fieldEdges)
+    {
+      return;
+    }
+  }
+
+  const u64 start = gettime();
+  if (!edgesFound)
+  {
+    SummarizeField(field, screenW, FIELD_TOP, screenH, fieldTiles);
+    edgeCount = FindFieldEdges(field, fieldTiles, screenW, FIELD_TOP, screenH, state.fieldLimit, fieldEdges,
+      EDGE_CAPACITY);
+    edgeSampled = 0;
+    edgeMicros = 0;
+    edgesFound = true;
+  }
+
+  for (; edgeSampled < edgeCount && !renderCancel; ++edgeSampled)
+  {
+    sampleEdge(state, fieldEdges[edgeSampled], screenW, screenW2, screenH2);
+  }
+
+  edgeMicros += static_cast<u32>(ticks_to_microsecs(gettime() - start));
+}
+
+/**
+ * Whether every edge of the field has been sampled, so the blended colours can
+ * be drawn
+ */
+static inline bool edgesReady()
+{
+  return edgesFound && edgeSampled == edgeCount;
+}
+
+/**
+ * Throws the edge list away, for a field that changed or stopped being
+ * antialiased
+ */
+static void dropEdges()
+{
+  edgeCount = 0;
+  edgeSampled = 0;
+  edgesFound = false;
+  ++edgeSerial;
+}
+
+/**
+ * Brings the field up to date for one frame, and checks the finished field
+ * against the row engine if the debug strip asked. A finished field is then
+ * antialiased once input has stopped. Runs on the render thread when there is
+ * one
+ *
+ * @return True when the field changed
+ */
+static bool computeView(MandelbrotState& state, RenderJob& job, int screenW, int screenH, int screenW2, int screenH2)
+{
+  const bool changed = computeField(state, job, screenW, screenH, screenW2, screenH2);
+  if (changed || (edgesFound && !job.antialias))
+  {
+    dropEdges();
+  }
+
+  // Doubles cannot resolve a deeper view, so the row engine is no reference there
+  if (job.checkRequested && !job.checkServed && state.refineStep == 0)
+  {
+    const int mismatches = !runsEveryEngine(fieldTier)
+      ? -1 : compareWithRowEngine(state, screenW, screenH, screenW2, screenH2);
+    if (!renderCancel)
+    {
+      fieldMismatches = mismatches;
+      job.checkServed = true;
+    }
+  }
+
+  storeCachedField(state, job, screenW, screenH);
+
+  const bool finished = (state.refineStep == 0 && !state.process && !state.degraded && !renderCancel);
+  if (job.antialias && finished && !job.interacting && (!edgesFound || edgeSampled < edgeCount))
+  {
+    antialiasField(state, screenW, screenH, screenW2, screenH2);
+  }
+
+  return changed;
+}
+
+/**
+ * Copies what the next job reads into renderJob, once the requests the last
+ * one served have been cleared. Only called between jobs
+ */
+static void takeRenderJob(MandelbrotState& state)
+{
+  if (renderJob.checkServed)
+  {
+    state.checkRequested = false;
+  }
+  if (renderJob.markServed)
+  {
+    state.markRequested = false;
+  }
+
+  renderJob.interacting = state.interacting();
+  renderJob.progressive = state.progressive;
+  renderJob.antialias = state.antialias;
+  renderJob.checkRequested = state.checkRequested;
+  renderJob.markRequested = state.markRequested;
+  renderJob.checkServed = false;
+  renderJob.markServed = false;
+}
+
+/**
+ * Renders the Mandelbrot set to the framebuffer. With GX available the pack
+ * stage is the GPU's: the field goes up only when it changed, and the palette
+ * and its rotation only when they did.
+ *
+ * A zoom first shows the old field scaled into place, and keeps showing it
+ * while the passes of a progressive render are still coarser than it is.
+ *
+ * Once the edges of a finished field have been sampled, the CPU packs their
+ * pairs again from the blended colours, or GX lays them over the field.
+ *
+ * With the render thread running, the frame only looks at the field between
+ * jobs, and otherwise draws the texture the last finished one left
+ */
+static void renderMandelbrot(
+  MandelbrotState& state,
+  u32* framebuffer,
+  PalettePtr currentPalette,
+  int screenW,
+  int screenH,
+  int screenW2,
+  int screenH2)
+{
+  if (!gxPalette)
+  {
+    state.previewScale = 1.0;
+    takeRenderJob(state);
+    const bool changed = computeView(state, renderJob, screenW, screenH, screenW2, screenH2);
+    ProfileMark(FramePhase::Compute);
+    if (changed)
+    {
+      SummarizeField(field, screenW, FIELD_TOP, screenH, fieldTiles);
+    }
+    PackField(field, fieldTiles, framebuffer, screenW, FIELD_TOP, screenH, state.fieldLimit, state.cycle, currentPalette);
+    if (edgesReady())
+    {
+      PackFieldEdges(field, fieldEdges, edgeCount, framebuffer, state.fieldLimit, state.cycle, currentPalette);
+    }
+  }
+  else if (renderThread == LWP_THREAD_NULL && state.previewing() && (state.previewFresh || state.zoomHeld))
+  {
+    // The render waits a frame, so a zoom shows within one however long the
+    // view takes, and waits for a held zoom to stop moving
+    state.previewFresh = false;
+    GXDisplaySetPalette(currentPalette, state.cycle);
+    GXDisplayDrawPreview(framebuffer, state.previewCol, state.previewRow, state.previewScale);
+  }
+  else
+  {
+    // The render thread's field can only be read between its jobs, and not at
+    // all when the view is about to start over, cancelled or not
+    const bool threaded = (renderThread != LWP_THREAD_NULL);
+    const bool readable = !threaded || (!renderBusy && !state.process);
+    if (readable)
+    {
+      if (!threaded)
+      {
+        takeRenderJob(state);
+      }
+      bool changed = threaded ? renderChanged : computeView(state, renderJob, screenW, screenH, screenW2, screenH2);
+      renderChanged = false;
+      ProfileMark(FramePhase::Compute);
+
+      // Block size of the pass just finished, 1 once the view is complete
+      const int finished = (state.refineStep > 0) ? (state.refineStep << 1) : 1;
+      if (state.previewing() && finished * state.previewScale <= 1.0)
+      {
+        state.previewScale = 1.0;
+        changed = true;
+      }
+
+      if (changed && !state.previewing())
+      {
+        SummarizeField(field, screenW, FIELD_TOP, screenH, fieldTiles);
+        GXDisplayUploadField(field, fieldTiles, state.fieldLimit);
+      }
+    }
+    GXDisplaySetPalette(currentPalette, state.cycle);
+
+    // The edges' colours follow the palette, so they go up after it
+    if (readable)
+    {
+      GXDisplaySetEdges(fieldEdges, edgesReady() ? edgeCount : 0, state.fieldLimit, edgeSerial, state.cycling);
+    }
+
+    if (state.previewing())
+    {
+      GXDisplayDrawPreview(framebuffer, state.previewCol, state.previewRow, state.previewScale);
+    }
+    else
+    {
+      GXDisplayDraw(framebuffer);
+    }
+  }
+}
+
+/**
+ * Writes a number right aligned into a field exactly width columns wide, or a
+ * "999+" style marker when it will not fit. The console is one row tall and
+ * text past its last column wraps onto a row that is not there, so every field
+ * on the debug strip has to have a width that cannot grow.
+ */
+static void fitField(char* out, size_t size, double value, int markerCap, int width, int decimals)
+{
+  if (snprintf(out, size, "%*.*f", width, decimals, value) > width)
+  {
+    snprintf(out, size, "%*d+", width - 1, markerCap);
+  }
+}
+
+/**
+ * Prints the debug strip: frame timings, iteration counts, memory, battery
+ */
+static void printDebugLine(const MandelbrotState& state, const WPADData* wd, u32 frameMicros)
+{
+  u32 fps = (frameMicros > 0) ? ((1000000u + (frameMicros >> 1)) / frameMicros) : 0;
+  u32 avgIterPx = (fieldIterPixels > 0) ? static_cast<u32>(fieldIterSum / fieldIterPixels) : 0;
+
+  char fpsText[8];
+  char renderText[12];
+  char freeText[12];
+  fitField(fpsText, sizeof(fpsText), fps, 999, 4, 0);
+  fitField(renderText, sizeof(renderText), lastRenderMicros / 1000.0, 9999, 6, 1);
+  fitField(freeText, sizeof(freeText), SYS_GetArena1Size() / (1024.0 * 1024.0), 999, 5, 1);
+
+  printf(" FPS:%s RenTime:%sms Iter:%4d AvgIterPx:%4u FreeMem:%sMB Bat:%3u",
+    fpsText, renderText, state.limit, avgIterPx, freeText,
+    static_cast<unsigned>(wd ? wd->battery_level : 0));
+}
+
+/**
+ * Prints the render page of the debug strip: which engine drew the field, how
+ * many of its pixels were iterated against how many were filled in, how many
+ * a grid zoom or a raised limit carried over, and how many differ from the row
+ * engine once D-pad Left has checked. Until then, a field dragged since it
+ * rendered shows how many pixels or samples the last drag computed along its
+ * edges
+ */
+static void printRenderLine(const MandelbrotState& state)
+{
+  const u32 total = fieldIterPixels + fieldFilledPixels;
+  const u32 skipped = (total > 0) ? static_cast<u32>((100ull * fieldFilledPixels) / total) : 0;
+
+  printf(" Engine:%-9s Calc:%6u Fill:%6u Skip:%3u%%",
+    fieldEngineName, fieldIterPixels, fieldFilledPixels, skipped);
+
+  if (state.gridZoom)
+  {
+    printf(" Carry:%6u", fieldCarriedPixels);
+  }
+  else
+  {
+    printf(" Grid:Off");
+  }
+
+  if (fieldMismatches >= 0)
+  {
+    printf(" Diff:%6d", fieldMismatches);
+  }
+  else if (fieldPanPixels >= 0)
+  {
+    printf(" Pan:%7d", fieldPanPixels);
+  }
+}
+
+/**
+ * Prints the precision page of the debug strip: the tier that drew the field,
+ * the time each tier last took over a whole view, and for perturbation the
+ * reference count and how many iterations the series approximation skipped.
+ * Other tiers show how many edges were antialiased and how long that took
+ */
+static void printPrecisionLine(const MandelbrotState& state)
+{
+  char floatText[12];
+  char doubleText[12];
+  char ddText[12];
+  char deepText[12];
+  fitField(floatText, sizeof(floatText), tierRenderMicros[0] / 1000.0, 9999, 6, 1);
+  fitField(doubleText, sizeof(doubleText), tierRenderMicros[1] / 1000.0, 9999, 6, 1);
+  fitField(ddText, sizeof(ddText), tierRenderMicros[2] / 1000.0, 9999, 6, 1);
+  fitField(deepText, sizeof(deepText), tierRenderMicros[3] / 1000.0, 9999, 6, 1);
+
+  printf(" Tier:%-6s F:%sms D:%sms DD:%sms P:%sms",
+    PrecisionTierNames[static_cast<int>(fieldTier)], floatText, doubleText, ddText, deepText);
+
+  if (fieldTier == PrecisionTier::Perturbation)
+  {
+    printf(" Ref:%d SA:%4d", deepStats.references, deepStats.seriesSkip);
+  }
+  else if (state.antialias)
+  {
+    char edgeText[12];
+    fitField(edgeText, sizeof(edgeText), edgeMicros / 1000.0, 9999, 6, 1);
+    printf(" AA:%5d %sms", edgeCount, edgeText);
+  }
+  else
+  {
+    printf(" AA:Off");
+  }
+}
+
+/**
+ * Draws a histogram as one glyph per slice into bars, denser for fuller slices
+ * on a log scale, and terminates it
+ */
+static void drawHistogram(char* bars, const u32* counts, int bins)
+{
+  static const char Glyphs[] = " .:-=+*#%@";
+  static constexpr int GLYPH_TOP = sizeof(Glyphs) - 2;
+
+  u32 fullest = 1;
+  for (int b = 0; b < bins; ++b)
+  {
+    fullest = std::max(fullest, counts[b]);
+  }
+
+  // Bit lengths stand in for logarithms. An empty slice stays blank and any
+  // other shows at least the first glyph
+  const int fullestBits = 32 - __builtin_clz(fullest);
+  for (int b = 0; b < bins; ++b)
+  {
+    const u32 count = counts[b];
+    const int bits = (count > 0) ? (32 - __builtin_clz(count)) : 0;
+    bars[b] = Glyphs[(count > 0) ? std::max(1, (bits * GLYPH_TOP) / fullestBits) : 0];
+  }
+  bars[bins] = '\0';
+}
+
+/**
+ * Prints the limit page of the debug strip: the limit and whether it is on
+ * automatic, the share of the field at the limit, and the escape-count
+ * histogram
+ */
+static void printLimitLine(const MandelbrotState& state)
+{
+  u32 total = fieldInterior;
+  for (int b = 0; b < HISTOGRAM_BINS; ++b)
+  {
+    total += limitHistogram[b];
+  }
+
+  char bars[HISTOGRAM_BINS + 1];
+  drawHistogram(bars, limitHistogram, HISTOGRAM_BINS);
+
+  const u32 inside = (total > 0) ? static_cast<u32>((100ull * fieldInterior) / total) : 0;
+  printf(" Limit:%4d %-6s Inside:%3u%% Hist:[%s]",
+    state.limit, state.autoLimit ? "Auto" : "Manual", inside, bars);
+}
+
+/**
+ * Prints the governor page of the debug strip: its level and whether input is
+ * keeping it engaged, the budget and how far the last frame ran past it, and
+ * the first pass, finest pass and limit the level allows
+ */
+static void printGovernorLine(const MandelbrotState& state)
+{
+  const bool engaged = state.interacting();
+  const GovernorLevel& governor = GovernorLevels[engaged ? governorLevel : 0];
+  const int finestStep = engaged ? std::max(governor.finestStep, INTERACTIVE_STEP) : 1;
+
+  char overText[12];
+  fitField(overText, sizeof(overText), governorOverMicros / 1000.0, 9999, 6, 1);
+
+  printf(" Gov:%d %-4s Budget:%2ums Over:%sms Coarse:%2d Finest:%d Limit:%4d",
+    governorLevel, engaged ? "Busy" : "Idle", RENDER_BUDGET_MICROS / 1000, overText,
+    governor.coarseStep, finestStep, std::max(1, state.limit >> governor.limitShift));
+}
+
+/**
+ * Prints the cost page of the debug strip: how the field's pixels left the
+ * kernel, as shares of every pixel written, and the average count of the
+ * dearest tile in the heatmap under it
+ */
+static void printCostLine()
+{
+  const u32 total = fieldIterPixels + fieldFilledPixels;
+  const double share = (total > 0) ? 100.0 / total : 0.0;
+
+  printf(" Cut:%5.1f%% Per:%5.1f%% Esc:%5.1f%% Lim:%5.1f%% Fill:%5.1f%% Hot:%5u",
+    kernelExits.shortcut * share, kernelExits.periodic * share, kernelExits.escaped * share,
+    kernelExits.limit * share, fieldFilledPixels * share, fieldHottestTile);
+}
+
+/**
+ * Prints the frame page of the debug strip: the median, 90th and 99th
+ * percentile frame times over the profiler's ring, the median wait for the
+ * flip, a histogram of frame times, and the last trace written to SD
+ */
+static void printFrameLine()
+{
+  static u32 times[PROFILE_FRAMES];
+  const int count = ProfileTimes(times, -1);
+
+  u32 bins[HISTOGRAM_BINS] = {};
+  for (int i = 0; i < count; ++i)
+  {
+    ++bins[std::min(times[i] / FRAME_BIN_MICROS, static_cast<u32>(HISTOGRAM_BINS - 1))];
+  }
+  char bars[HISTOGRAM_BINS + 1];
+  drawHistogram(bars, bins, HISTOGRAM_BINS);
+
+  // Each percentile only needs its own element in place, and once one is,
+  // the next one up is somewhere above it
+  char percentText[3][12];
+  static const int Percents[3] = {50, 90, 99};
+  int below = 0;
+  for (int i = 0; i < 3; ++i)
+  {
+    const int rank = (count * Percents[i]) / 100;
+    std::nth_element(times + below, times + rank, times + count);
+    below = rank;
+    fitField(percentText[i], sizeof(percentText[i]), (count > 0) ? times[rank] / 1000.0 : 0.0, 999, 5, 1);
+  }
+
+  const int waits = ProfileTimes(times, static_cast<int>(FramePhase::Present));
+  std::nth_element(times, times + (waits >> 1), times + waits);
+  char waitText[12];
+  fitField(waitText, sizeof(waitText), (waits > 0) ? times[waits >> 1] / 1000.0 : 0.0, 999, 5, 1);
+
+  printf(" Frame p50:%s p90:%s p99:%s Wait:%s Hist:[%s]",
+    percentText[0], percentText[1], percentText[2], waitText, bars);
+
+  if (traceFile >= 0)
+  {
+    printf(" SD:%02d", traceFile);
+  }
+  else if (traceFile == -1)
+  {
+    printf(" SD:--");
+  }
+}
+
+/**
+ * Prints the cache page of the debug strip: the fields cached and the room
+ * they take, hits against lookups, the last load and store times, and which
+ * bookmark 1 and 2 last went to out of how many
+ */
+static void printCacheLine(const MandelbrotState& state)
+{
+  const FieldCacheStats& cache = FieldCacheGetStats();
+
+  char hitText[8];
+  char lookupText[8];
+  char loadText[12];
+  char saveText[12];
+  fitField(hitText, sizeof(hitText), cache.hits, 999, 4, 0);
+  fitField(lookupText, sizeof(lookupText), cache.hits + cache.misses, 999, 4, 0);
+  fitField(loadText, sizeof(loadText), cache.loadMicros / 1000.0, 999, 5, 1);
+  fitField(saveText, sizeof(saveText), cache.storeMicros / 1000.0, 9999, 6, 1);
+
+  printf(" Cache:%3d %4.1fMB Hit:%s/%s Load:%sms Save:%sms Mark:%2d/%-2d",
+    cache.entries, cache.bytes / (1024.0 * 1024.0), hitText, lookupText, loadText, saveText,
+    (state.markIndex < cache.marks) ? state.markIndex + 1 : 0, cache.marks);
+}
+
+/**
+ * Height of a poster width pixels wide framed like the field, kept even so it
+ * can be turned on its side as readily
+ */
+static inline int posterHeight(int width, int screenW, int screenH)
+{
+  return ((width * (screenH - FIELD_TOP)) / screenW) & ~1;
+}
+
+/**
+ * Prints the poster page of the debug strip. While a poster is being written
+ * it takes the strip over whatever the page, with the bands done, the rate
+ * so far and the time left at that rate
+ */
+static void printPosterLine(const MandelbrotState& state, int screenW, int screenH)
+{
+  if (!posterActive)
+  {
+    const int width = PosterWidths[state.posterWidth];
+    printf(" Poster %dx%d  1/2:Size  Left:Start", width, posterHeight(width, screenW, screenH));
+
+    if (posterFile >= 0)
+    {
+      printf("  SD:%02d", posterFile);
+    }
+    else if (posterFile == -1)
+    {
+      printf("  SD:--");
+    }
+    return;
+  }
+
+  // The band in progress moves row on once it is written, which is all this
+  // reads of it
+  const int row = poster.row;
+  const int bands = (poster.view.height + poster.bandRows - 1) / poster.bandRows;
+  const double seconds = ticks_to_microsecs(gettime() - posterStart) / 1000000.0;
+  const double rate = (seconds > 0.0) ? (static_cast<double>(row) * poster.view.width) / (seconds * 1000000.0) : 0.0;
+  const int left = (row > 0) ? std::min(static_cast<int>(seconds * (poster.view.height - row) / row), 999 * 60 + 59) : 0;
+
+  char rateText[8];
+  fitField(rateText, sizeof(rateText), rate, 99, 5, 2);
+  printf(" Poster %dx%d Band %3d/%-3d %sMpx/s ETA %3d:%02d  Left:Cancel",
+    poster.view.width, poster.view.height, std::min(row / poster.bandRows + 1, bands), bands,
+    rateText, left / 60, left % 60);
+}
+
+/**
+ * Prints the zoom path page of the debug strip. While a path is being
+ * rendered it takes the strip over whatever the page, with the frames
+ * written, the frame and byte rates so far and the time left at that rate
+ */
+static void printPathLine()
+{
+  if (!pathActive)
+  {
+    printf(" Path %s  Left:Start", PATH_FILE);
+
+    if (pathBadLine > 0)
+    {
+      printf("  Bad line %d", pathBadLine);
+    }
+    else if (pathFile >= 0)
+    {
+      printf("  SD:%02d", pathFile);
+    }
+    else if (pathFile == -1)
+    {
+      printf("  SD:--");
+    }
+    return;
+  }
+
+  const int frames = pathWriter.frames;
+  const double seconds = ticks_to_microsecs(gettime() - pathStart) / 1000000.0;
+  const double rate = (seconds > 0.0) ? frames / seconds : 0.0;
+  const double bytesRate = (seconds > 0.0) ? pathWriter.bytes / (seconds * 1000000.0) : 0.0;
+  const int left =
+    (frames > 0) ? std::min(static_cast<int>(seconds * (zoomPath.frameCount - frames) / frames), 999 * 60 + 59) : 0;
+
+  char rateText[8];
+  char bytesText[8];
+  fitField(rateText, sizeof(rateText), rate, 99, 5, 2);
+  fitField(bytesText, sizeof(bytesText), bytesRate, 99, 5, 2);
+  printf(" Path %dx%d Frame %4d/%-4d %sfps %sMB/s ETA %3d:%02d  Left:Cancel",
+    zoomPath.width, zoomPath.height, frames, zoomPath.frameCount, rateText, bytesText, left / 60, left % 60);
+}
+
+/**
+ * Prints the normal strip: view centre, zoom, and the cursor's coordinate
+ */
+static void printCoordinateLine(const MandelbrotState& state, const WPADData* wd, int screenW2, int screenH2)
+{
+  printf(" cX:%.8f cY:%.8f", state.centerX, state.centerY == -0.0 ? 0.0 : -state.centerY);
+  printf("  zoom:%.4e ", INITIAL_ZOOM / state.zoom);
+
+  // Display cursor coordinates if IR is valid
+  if (wd && wd->ir.valid)
+  {
+    printf(" re:%.8f im:%.8f",
+      (wd->ir.x - screenW2) * state.zoom + state.centerX,
+      (screenH2 - wd->ir.y) * state.zoom - state.centerY);
+  }
+  else if (wd)
+  {
+    printf(" No Cursor");
+  }
+}
+
+/**
+ * Updates the display with coordinate information
+ */
+static void updateDisplay(const MandelbrotState& state, const WPADData* wd, int screenW2, int screenH2)
+{
+  // Sampled every frame rather than only in debug mode, so the first frame
+  // after the toggle measures one frame instead of the whole time it was off
+  u64 currentTime = gettime();
+  u32 frameMicros = static_cast<u32>(ticks_to_microsecs(currentTime - lastTime));
+  lastTime = currentTime;
+
+  if (posterActive || (state.debugMode && state.debugPage == 7))
+  {
+    printPosterLine(state, screenW2 << 1, screenH2 << 1);
+  }
+  else if (pathActive || (state.debugMode && state.debugPage == 9))
+  {
+    printPathLine();
+  }
+  else if (state.debugMode && state.debugPage == 8)
+  {
+    printCacheLine(state);
+  }
+  else if (state.debugMode && state.debugPage == 1)
+  {
+    printRenderLine(state);
+  }
+  else if (state.debugMode && state.debugPage == 2)
+  {
+    printPrecisionLine(state);
+  }
+  else if (state.debugMode && state.debugPage == 3)
+  {
+    printLimitLine(state);
+  }
+  else if (state.debugMode && state.debugPage == 4)
+  {
+    printGovernorLine(state);
+  }
+  else if (state.debugMode && state.debugPage == 5)
+  {
+    printCostLine();
+  }
+  else if (state.debugMode && state.debugPage == 6)
+  {
+    printFrameLine();
+  }
+  else if (state.debugMode)
+  {
+    printDebugLine(state, wd, frameMicros);
+  }
+  else
+  {
+    printCoordinateLine(state, wd, screenW2, screenH2);
+  }
+}
+
+/**
+ * Tints the frame by the average count of each tile of the field, for the
+ * cost page of the debug strip. Luma is halved over a floor so the picture,
+ * interior included, still shows through, and chroma runs from blue through
+ * green to red on a log scale that tops out at the limit
+ *
+ * @return The highest tile average
+ */
+static u32 tintCostHeatmap(u32* framebuffer, int screenW, int screenH, int limit)
+{
+  const double scale = 255.0 / std::log1p(static_cast<double>(limit));
+  u32 hottest = 0;
+
+  for (int y0 = FIELD_TOP; y0 < screenH; y0 += FIELD_TILE)
+  {
+    const int y1 = std::min(y0 + FIELD_TILE, screenH);
+    for (int x0 = 0; x0 < screenW; x0 += FIELD_TILE)
+    {
+      const int x1 = std::min(x0 + FIELD_TILE, screenW);
+      u32 sum = 0;
+      for (int y = y0; y < y1; ++y)
+      {
+        const FieldCount* rowField = field + (screenW * y);
+        for (int x = x0; x < x1; ++x)
+        {
+          sum += std::min<u32>(rowField[x], limit);
+        }
+      }
+
+      const u32 mean = sum / static_cast<u32>((y1 - y0) * (x1 - x0));
+      hottest = std::max(hottest, mean);
+
+      // Blue at U 240 V 110, green at U 54 V 34, red at U 90 V 240
+      const int heat = std::min(255, static_cast<int>(std::log1p(static_cast<double>(mean)) * scale));
+      const u32 u = (heat < 128) ? 240 - (186 * heat) / 128 : 54 + (36 * (heat - 128)) / 127;
+      const u32 v = (heat < 128) ? 110 - (76 * heat) / 128 : 34 + (206 * (heat - 128)) / 127;
+
+      for (int y = y0; y < y1; ++y)
+      {
+        u32* rowXfb = framebuffer + ((screenW * y) >> 1);
+        for (int x = x0 >> 1; x < (x1 >> 1); ++x)
+        {
+          const u32 luma1 = 64 + (rowXfb[x] >> 25);
+          const u32 luma2 = 64 + ((rowXfb[x] >> 9) & 0x7F);
+          rowXfb[x] = (luma1 << 24) | (u << 16) | (luma2 << 8) | v;
+        }
+      }
+    }
+  }
+
+  return hottest;
+}
+
+static void drawdot(void* xfb, GXRModeObj* rmode, int cx, int cy, u32 color)
+{
+  u32* fb = static_cast<u32*>(xfb);
+  const int fbWidthHalf = rmode->fbWidth >> 1;
+  const int height = rmode->xfbHeight;
+
+  // Cursor dimensions (approx 5x9 pixels)
+  const int rx = 2;
   const int ry = 4;
 
   // Use std::max/min to clamp values without branching (reduces complexity)
@@ -424,30 +2948,366 @@ static void drawdot(void* xfb, GXRModeObj* rmode, int cx, int cy, u32 color)
   u32* row = fb + (y_start * fbWidthHalf);
   for (int y = y_start; y <= y_end; ++y)
   {
-    for (int x = x_start; x <= x_end; ++x)
-    {
-      row[x] = color;
-    }
-    row += fbWidthHalf;
+    for (int x = x_start; x <= x_end; ++x)
+    {
+      row[x] = color;
+    }
+    row += fbWidthHalf;
+  }
+}
+
+/**
+ * Does nothing on purpose. WPAD_ReadPending needs somewhere to report each
+ * event it drains, and draining is the only reason the call is there
+ */
+static void countevs(int chan, const WPADData* data)
+{
+}
+
+/**
+ * Counts the frame loop's time since it last took the CPU into frameLoopMicros,
+ * before it waits on the video interface or the render thread
+ */
+static void frameLoopSleeps()
+{
+  frameLoopMicros = frameLoopMicros + static_cast<u32>(ticks_to_microsecs(gettime() - frameLoopWoke));
+}
+
+/**
+ * Hands the render thread its next job
+ */
+static void startRender()
+{
+  LWP_MutexLock(renderMutex);
+  renderCancel = false;
+  renderBusy = true;
+  LWP_CondBroadcast(renderCond);
+  LWP_MutexUnlock(renderMutex);
+}
+
+/**
+ * Cancels the render thread's job, if it has one, and waits for it to stop.
+ * The field and the view are the caller's once this returns
+ */
+static void stopRender()
+{
+  if (renderThread == LWP_THREAD_NULL)
+  {
+    return;
+  }
+
+  frameLoopSleeps();
+  LWP_MutexLock(renderMutex);
+  renderCancel = renderBusy;
+  while (renderBusy)
+  {
+    LWP_CondWait(renderCond, renderMutex);
+  }
+  LWP_MutexUnlock(renderMutex);
+  frameLoopWoke = gettime();
+}
+
+/**
+ * Stops the render thread for good, before what it works on is freed
+ */
+static void endRenderThread()
+{
+  if (renderThread == LWP_THREAD_NULL)
+  {
+    return;
+  }
+
+  stopRender();
+  LWP_MutexLock(renderMutex);
+  renderQuit = true;
+  LWP_CondBroadcast(renderCond);
+  LWP_MutexUnlock(renderMutex);
+
+  LWP_JoinThread(renderThread, nullptr);
+  LWP_CondDestroy(renderCond);
+  LWP_MutexDestroy(renderMutex);
+  renderThread = LWP_THREAD_NULL;
+}
+
+/**
+ * Saves the command line that renders the finished poster again with the
+ * host tool, centre exact to the last bit, so a PC can redo it larger or
+ * deeper. Only a convenience, so a card too full for it still keeps the poster
+ */
+static void writePosterCommand()
+{
+  char path[32];
+  snprintf(path, sizeof(path), "sd:/wmcpp-poster-%02d.txt", posterNumber);
+  FILE* command = fopen(path, "w");
+  if (!command)
+  {
+    return;
+  }
+
+  const PosterView& view = poster.view;
+  char re[BIGFIXED_TEXT_SIZE];
+  char im[BIGFIXED_TEXT_SIZE];
+  BigFixedToString(view.centerRe, re);
+  BigFixedToString(view.centerIm, im);
+  fprintf(command, "wmcpp-poster wmcpp-poster-%02d.png %d %d %s %s %.17g %d %d %d\n",
+    posterNumber, view.width, view.height, re, im, view.spacing, view.limit, posterPalette, view.cycle);
+  fclose(command);
+}
+
+/**
+ * Starts a poster of the view on SD, framed like the field at the chosen
+ * width, with the limit asked for rather than one the governor capped
+ */
+static void startPoster(const MandelbrotState& state, int screenW, int screenH)
+{
+  PosterView view;
+  view.width = PosterWidths[state.posterWidth];
+  view.height = posterHeight(view.width, screenW, screenH);
+  view.spacing = state.zoom * screenW / view.width;
+  view.limit = state.limit;
+  view.palette = GetPalettePtr(state.paletteIndex);
+  view.cycle = state.cycle & 255;
+  view.cancel = &renderCancel;
+
+  // The screen centre sits half the strip above the field's, and the
+  // imaginary axis runs up the screen
+  view.centerRe = state.preciseX;
+  view.centerIm = BigFixedNegate(BigFixedAdd(state.preciseY, BigFixedFromDouble((FIELD_TOP >> 1) * state.zoom)));
+
+  posterOut = SDCreateNumbered("sd:/wmcpp-poster-%02d.png", posterNumber);
+  if (!posterOut)
+  {
+    posterFile = -1;
+    return;
+  }
+
+  snprintf(posterPath, sizeof(posterPath), "sd:/wmcpp-poster-%02d.png", posterNumber);
+  if (!PosterBegin(poster, view, posterOut, false))
+  {
+    fclose(posterOut);
+    posterOut = nullptr;
+    remove(posterPath);
+    posterFile = -1;
+    return;
+  }
+
+  posterPalette = state.paletteIndex;
+  posterWritten = true;
+  posterActive = true;
+  posterStart = gettime();
+}
+
+/**
+ * Closes the poster, ending its file when every band is in and deleting it
+ * when one was cancelled or failed. Only called between render thread jobs
+ */
+static void endPoster()
+{
+  bool written = posterWritten && PosterDone(poster);
+  if (written)
+  {
+    written = PosterFinish(poster);
+  }
+  else
+  {
+    PosterAbort(poster);
+  }
+
+  written = (fclose(posterOut) == 0) && written;
+  posterOut = nullptr;
+  posterActive = false;
+
+  if (written)
+  {
+    writePosterCommand();
+  }
+  else
+  {
+    remove(posterPath);
+  }
+  posterFile = written ? posterNumber : -1;
+}
+
+/**
+ * Reads the path file into zoomPath, noting the line that stopped it
+ *
+ * @return False when the file is missing or a line is not understood
+ */
+static bool readZoomPath()
+{
+  if (!SDMount())
+  {
+    return false;
+  }
+
+  FILE* in = fopen(PATH_FILE, "rb");
+  if (!in)
+  {
+    return false;
+  }
+
+  char* text = static_cast<char*>(malloc(PATH_FILE_BYTES + 1));
+  const size_t length = text ? fread(text, 1, PATH_FILE_BYTES, in) : 0;
+  fclose(in);
+  if (!text)
+  {
+    return false;
+  }
+
+  text[length] = '\0';
+  pathBadLine = ZoomPathParse(text, zoomPath);
+  free(text);
+  return pathBadLine == 0;
+}
+
+/**
+ * Starts rendering the zoom path from the path file to a numbered YUV4MPEG2
+ * video on SD. pathFrame starts before the first frame, which nothing has
+ * rendered yet
+ */
+static void startPath()
+{
+  pathBadLine = 0;
+  pathFile = -1;
+  if (!readZoomPath())
+  {
+    return;
+  }
+
+  const size_t fieldBytes = sizeof(FieldCount) * zoomPath.width * zoomPath.height;
+  pathFields[0] = static_cast<FieldCount*>(malloc(fieldBytes));
+  pathFields[1] = static_cast<FieldCount*>(malloc(fieldBytes));
+  pathOut = (pathFields[0] && pathFields[1]) ? SDCreateNumbered("sd:/wmcpp-path-%02d.y4m", pathNumber) : nullptr;
+
+  if (!pathOut || !ZoomPathBeginStream(pathWriter, zoomPath, pathOut))
+  {
+    if (pathOut)
+    {
+      fclose(pathOut);
+      pathOut = nullptr;
+      char name[32];
+      snprintf(name, sizeof(name), "sd:/wmcpp-path-%02d.y4m", pathNumber);
+      remove(name);
+    }
+    free(pathFields[0]);
+    free(pathFields[1]);
+    pathFields[0] = pathFields[1] = nullptr;
+    return;
+  }
+
+  pathFrame = -1;
+  pathRendered = true;
+  pathStart = gettime();
+  pathActive = true;
+}
+
+/**
+ * The render thread's job while a path is active: frame pathFrame into the
+ * buffer it takes turns with the frame before it
+ */
+static bool renderPathFrame()
+{
+  PosterView& view = pathViews[pathFrame & 1];
+  ZoomPathFrame(zoomPath, pathFrame, view);
+  view.cancel = &renderCancel;
+  return ZoomPathRender(view, pathFields[pathFrame & 1]);
+}
+
+/**
+ * Closes the video. Frames already written make a shorter video that plays,
+ * so only a failed write deletes it. Only called between render thread jobs
+ */
+static void endPath()
+{
+  const bool failed = pathRendered && pathWriter.frames < zoomPath.frameCount;
+  ZoomPathEnd(pathWriter);
+  const bool closed = (fclose(pathOut) == 0);
+  pathOut = nullptr;
+  free(pathFields[0]);
+  free(pathFields[1]);
+  pathFields[0] = pathFields[1] = nullptr;
+  pathActive = false;
+
+  if (failed || !closed || pathWriter.frames == 0)
+  {
+    char name[32];
+    snprintf(name, sizeof(name), "sd:/wmcpp-path-%02d.y4m", pathNumber);
+    remove(name);
+    pathFile = -1;
+    return;
   }
+  pathFile = pathNumber;
 }
 
 /**
- * Does nothing on purpose. WPAD_ReadPending needs somewhere to report each
- * event it drains, and draining is the only reason the call is there
+ * Moves the path on once the render thread's job is done: starts the next
+ * frame, then writes the one just rendered while that computes. The card's
+ * waits are when the render thread gets to run
  */
-static void countevs(int chan, const WPADData* data)
+static void advancePath()
 {
+  if (!pathRendered)
+  {
+    endPath();
+    return;
+  }
+
+  const int done = pathFrame;
+  if (done + 1 < zoomPath.frameCount)
+  {
+    pathFrame = done + 1;
+    startRender();
+  }
+
+  if (done < 0)
+  {
+    return;
+  }
+
+  if (!ZoomPathWriteFrame(pathWriter, pathViews[done & 1], pathFields[done & 1]))
+  {
+    stopRender();
+    pathRendered = true;
+    endPath();
+  }
+  else if (pathWriter.frames == zoomPath.frameCount)
+  {
+    endPath();
+  }
 }
 
 static void cleanup_field()
 {
   free(field);
   field = nullptr;
+  free(fieldTiles);
+  fieldTiles = nullptr;
+  free(traceQueue);
+  traceQueue = nullptr;
+  free(traceQueued);
+  traceQueued = nullptr;
+  free(carryField);
+  carryField = nullptr;
+  carryActive = false;
+  free(fieldEdges);
+  fieldEdges = nullptr;
+  edgeCount = 0;
+  edgesFound = false;
 }
 
 static void shutdown_system()
 {
+  endRenderThread();
+  if (posterActive)
+  {
+    endPoster();
+  }
+  if (pathActive)
+  {
+    pathRendered = false;
+    endPath();
+  }
+  GXDisplayShutdown();
   cleanup_field();
   if (xfb[0])
   {
@@ -567,16 +3427,29 @@ static void init()
 }
 
 /**
- * Palette buttons and the chord of both that toggles debug mode
+ * Palette buttons and the chord of both that steps through the debug pages
  */
 static void handlePaletteButtons(MandelbrotState& state, const WPADData* wd)
 {
   // Both palette handlers below also fire on this chord. They step down and
   // then back up, which cancels for any palette count, so debug mode toggles
-  // without disturbing the palette
+  // without disturbing the palette. Each press shows the next page, and the
+  // one after the last page switches the strip back to coordinates
   if ((wd->btns_d & WPAD_BUTTON_MINUS) && (wd->btns_d & WPAD_BUTTON_PLUS))
   {
-    state.debugMode = !state.debugMode;
+    if (!state.debugMode)
+    {
+      state.debugMode = true;
+      state.debugPage = 0;
+    }
+    else if (state.debugPage + 1 < DEBUG_PAGE_COUNT)
+    {
+      ++state.debugPage;
+    }
+    else
+    {
+      state.debugMode = false;
+    }
   }
 
   if (wd->btns_d & WPAD_BUTTON_MINUS)
@@ -591,10 +3464,26 @@ static void handlePaletteButtons(MandelbrotState& state, const WPADData* wd)
 }
 
 /**
- * Iteration limit buttons
+ * Iteration limit buttons. Either one alone takes the limit off automatic,
+ * and the chord of both puts it back
  */
 static void handleLimitButtons(MandelbrotState& state, const WPADData* wd)
 {
+  if ((wd->btns_d & WPAD_BUTTON_1) && (wd->btns_d & WPAD_BUTTON_2))
+  {
+    // Rendering the view again lets the histogram judge it straight away
+    state.autoLimit = !state.autoLimit;
+    state.nextLimit = 0;
+    state.process = state.autoLimit;
+    return;
+  }
+
+  if (wd->btns_d & (WPAD_BUTTON_1 | WPAD_BUTTON_2))
+  {
+    state.autoLimit = false;
+    state.nextLimit = 0;
+  }
+
   if (wd->btns_d & WPAD_BUTTON_2)
   {
     state.limit = (state.limit > 1) ? (state.limit >> 1) : 1;
@@ -612,6 +3501,72 @@ static void handleLimitButtons(MandelbrotState& state, const WPADData* wd)
   }
 }
 
+/**
+ * Bookmark buttons on the cache page: 1 goes to the next bookmark and 2 to the
+ * one before, both wrapping around. A bookmark saved in another video mode is
+ * a field of another size and stays where it is
+ */
+static void handleMarkButtons(MandelbrotState& state, const WPADData* wd, int screenW, int screenH)
+{
+  const int marks = FieldCacheGetStats().marks;
+  if (marks == 0 || !(wd->btns_d & (WPAD_BUTTON_1 | WPAD_BUTTON_2)))
+  {
+    return;
+  }
+
+  const int step = (wd->btns_d & WPAD_BUTTON_1) ? 1 : marks - 1;
+  state.markIndex = (state.markIndex < 0) ? ((step == 1) ? 0 : marks - 1) : ((state.markIndex + step) % marks);
+
+  FieldFileView view;
+  if (FieldCacheMarkView(state.markIndex, view) && view.width == screenW && view.top == FIELD_TOP
+    && view.height == screenH)
+  {
+    state.jumpTo(view);
+  }
+}
+
+/**
+ * Panning while B is held: the picture follows the pointer, and the D-pad
+ * moves the view PAN_STEP pixels a frame in the direction pressed
+ */
+static void handlePanButtons(MandelbrotState& state, const WPADData* wd)
+{
+  const int pointerX = static_cast<int>(wd->ir.x);
+  const int pointerY = static_cast<int>(wd->ir.y);
+
+  if (wd->btns_d & WPAD_BUTTON_B)
+  {
+    state.dragged = false;
+    state.dragTracking = false;
+  }
+
+  // The pointer only drags between two frames it was seen in, so losing it
+  // off screen does not make the view jump when it comes back
+  if (!wd->ir.valid)
+  {
+    state.dragTracking = false;
+  }
+  else
+  {
+    if (state.dragTracking && (pointerX != state.dragX || pointerY != state.dragY))
+    {
+      state.panView(pointerX - state.dragX, pointerY - state.dragY);
+      state.dragged = true;
+    }
+    state.dragX = pointerX;
+    state.dragY = pointerY;
+    state.dragTracking = true;
+  }
+
+  const int stepX = ((wd->btns_h & WPAD_BUTTON_LEFT) ? PAN_STEP : 0) - ((wd->btns_h & WPAD_BUTTON_RIGHT) ? PAN_STEP : 0);
+  const int stepY = ((wd->btns_h & WPAD_BUTTON_UP) ? PAN_STEP : 0) - ((wd->btns_h & WPAD_BUTTON_DOWN) ? PAN_STEP : 0);
+  if (stepX != 0 || stepY != 0)
+  {
+    state.panView(stepX, stepY);
+    state.dragged = true;
+  }
+}
+
 /**
  * Input Handler
  */
@@ -619,24 +3574,103 @@ static bool handleInput(MandelbrotState& state, const WPADData* wd, int screenW2
 {
   if (!wd)
   {
+    // A remote that drops out mid-zoom must not hold the render back
+    state.zoomHeld = false;
+    state.idleFrames = IDLE_FRAMES;
     return false;
   }
 
+  // Only buttons that change the view count. Palettes and the debug strip
+  // leave it alone, so they should not hold back its finest passes
+  if (wd->btns_h & VIEW_BUTTONS)
+  {
+    state.idleFrames = 0;
+  }
+  else if (state.idleFrames < IDLE_FRAMES)
+  {
+    ++state.idleFrames;
+  }
+
   handlePaletteButtons(state, wd);
-  handleLimitButtons(state, wd);
+
+  // The poster page gives 1 and 2 to the poster's width
+  if (state.debugMode && state.debugPage == 7)
+  {
+    if (wd->btns_d & WPAD_BUTTON_1)
+    {
+      state.posterWidth = std::min(state.posterWidth + 1, POSTER_WIDTH_COUNT - 1);
+    }
+    if (wd->btns_d & WPAD_BUTTON_2)
+    {
+      state.posterWidth = std::max(state.posterWidth - 1, 0);
+    }
+  }
+  else if (state.debugMode && state.debugPage == 8)
+  {
+    handleMarkButtons(state, wd, screenW2 << 1, screenH2 << 1);
+  }
+  else if (state.debugMode && state.debugPage == 1)
+  {
+    // The render page gives 1 and 2 to grid zoom, which takes effect from the
+    // next press of A
+    if (wd->btns_d & WPAD_BUTTON_1)
+    {
+      state.gridZoom = true;
+    }
+    if (wd->btns_d & WPAD_BUTTON_2)
+    {
+      state.gridZoom = false;
+    }
+  }
+  else if (state.debugMode && state.debugPage == 2)
+  {
+    // The precision page gives 1 and 2 to antialiasing, which the next frame
+    // of a finished field picks up
+    if (wd->btns_d & WPAD_BUTTON_1)
+    {
+      state.antialias = true;
+    }
+    if (wd->btns_d & WPAD_BUTTON_2)
+    {
+      state.antialias = false;
+    }
+  }
+  else
+  {
+    handleLimitButtons(state, wd);
+  }
 
   if (wd->btns_d & WPAD_BUTTON_A)
   {
     state.mouseX = wd->ir.x;
     state.mouseY = wd->ir.y;
     state.zoomView(screenW2, screenH2);
+    state.heldFrames = 0;
+  }
+  else if ((wd->btns_h & WPAD_BUTTON_A) && gxPalette && ++state.heldFrames > HOLD_DELAY_FRAMES)
+  {
+    // Only the preview can keep up with a view that changes every frame
+    state.mouseX = wd->ir.x;
+    state.mouseY = wd->ir.y;
+    state.zoomTowards(HOLD_ZOOM_STEP, screenW2, screenH2);
+    state.zoomHeld = true;
+  }
+  else if (!(wd->btns_h & WPAD_BUTTON_A))
+  {
+    state.zoomHeld = false;
   }
 
-  if (wd->btns_d & WPAD_BUTTON_B)
+  // B drags. Held, it takes the D-pad over for panning too, and only a
+  // press that did neither starts over when it comes back up
+  if (wd->btns_h & WPAD_BUTTON_B)
   {
-    state.zoom = INITIAL_ZOOM;
-    state.centerX = state.centerY = state.oldX = state.oldY = 0;
-    state.process = true;
+    handlePanButtons(state, wd);
+    return ((wd->btns_d & WPAD_BUTTON_HOME) || reboot);
+  }
+
+  if ((wd->btns_u & WPAD_BUTTON_B) && !state.dragged)
+  {
+    state.resetView();
   }
 
   if (wd->btns_d & WPAD_BUTTON_DOWN)
@@ -644,9 +3678,191 @@ static bool handleInput(MandelbrotState& state, const WPADData* wd, int screenW2
     state.cycling = !state.cycling;
   }
 
+  // Only the next view changes mode. A render already under way finishes the
+  // way it started
+  if (wd->btns_d & WPAD_BUTTON_UP)
+  {
+    state.progressive = !state.progressive;
+  }
+
+  if (wd->btns_d & WPAD_BUTTON_RIGHT)
+  {
+    state.engine = static_cast<RenderEngine>((static_cast<int>(state.engine) + 1) % RENDER_ENGINE_COUNT);
+    state.process = true;
+  }
+
+  if ((wd->btns_d & WPAD_BUTTON_LEFT) && state.debugMode)
+  {
+    state.traceRequested = (state.debugPage == 6);
+    state.posterRequested = (state.debugPage == 7);
+    state.markRequested = (state.debugPage == 8);
+    state.pathRequested = (state.debugPage == 9);
+    state.checkRequested =
+      !state.traceRequested && !state.posterRequested && !state.markRequested && !state.pathRequested;
+  }
+
   return ((wd->btns_d & WPAD_BUTTON_HOME) || reboot);
 }
 
+/**
+ * Whether handleInput is about to move the view this frame: a press of a
+ * view button, B coming up to reset it, a drag or D-pad step while B is held,
+ * or a step of a held zoom. Holding a button still, or letting go of one, is
+ * not, so the job working on the view it left carries on
+ */
+static bool changesView(const MandelbrotState& state, const WPADData* wd)
+{
+  if (!wd)
+  {
+    return false;
+  }
+
+  if (wd->btns_d & VIEW_BUTTONS & ~WPAD_BUTTON_B)
+  {
+    return true;
+  }
+
+  if ((wd->btns_h & WPAD_BUTTON_A) && gxPalette && state.heldFrames + 1 > HOLD_DELAY_FRAMES)
+  {
+    return true;
+  }
+
+  if (wd->btns_h & WPAD_BUTTON_B)
+  {
+    if (wd->btns_h & (WPAD_BUTTON_LEFT | WPAD_BUTTON_RIGHT | WPAD_BUTTON_UP | WPAD_BUTTON_DOWN))
+    {
+      return true;
+    }
+
+    // A press starts tracking the pointer afresh, so only later frames drag
+    const bool tracking = !(wd->btns_d & WPAD_BUTTON_B) && state.dragTracking && wd->ir.valid;
+    return tracking
+      && (static_cast<int>(wd->ir.x) != state.dragX || static_cast<int>(wd->ir.y) != state.dragY);
+  }
+
+  return (wd->btns_u & WPAD_BUTTON_B) && !state.dragged;
+}
+
+/**
+ * Moves the governor a level towards speed when a frame computed past the
+ * budget, and a level back towards quality once frames have stayed well
+ * inside it for a while. Frames after input stops run at full quality and
+ * are allowed to take as long as that takes, so they do not count
+ */
+static void updateGovernor(bool interacting, u32 renderMicros)
+{
+  governorOverMicros = static_cast<int>(renderMicros) - static_cast<int>(RENDER_BUDGET_MICROS);
+
+  if (!interacting)
+  {
+    governorCalmFrames = 0;
+    return;
+  }
+
+  if (governorOverMicros > 0)
+  {
+    governorLevel = std::min(governorLevel + 1, GOVERNOR_LEVEL_COUNT - 1);
+    governorCalmFrames = 0;
+  }
+  else if (renderMicros < (RENDER_BUDGET_MICROS >> 1) && ++governorCalmFrames >= GOVERNOR_SETTLE_FRAMES)
+  {
+    governorLevel = std::max(governorLevel - 1, 0);
+    governorCalmFrames = 0;
+  }
+}
+
+/**
+ * Runs jobs for the frame loop until told to quit. A job is the one call to
+ * computeView a frame makes when there is no thread, a band of the poster
+ * while one is being written, or the next frame of a zoom path. The governor
+ * is fed from here, since what it judges is how long computing takes. The
+ * frame loop preempts a job whenever it wakes, so its share of the wall time
+ * is taken off
+ */
+static void* renderWorker(void* arg)
+{
+  MandelbrotState& state = *static_cast<MandelbrotState*>(arg);
+
+  LWP_MutexLock(renderMutex);
+  while (true)
+  {
+    while (!renderBusy && !renderQuit)
+    {
+      LWP_CondWait(renderCond, renderMutex);
+    }
+
+    if (renderQuit)
+    {
+      break;
+    }
+    LWP_MutexUnlock(renderMutex);
+
+    // A poster's bands and a path's frames take the place of the view's jobs
+    // until they are done
+    bool changed = false;
+    if (posterActive)
+    {
+      posterWritten = PosterRenderBand(poster);
+    }
+    else if (pathActive)
+    {
+      pathRendered = renderPathFrame();
+    }
+    else
+    {
+      const u64 renderStart = gettime();
+      const u32 loopBefore = frameLoopMicros;
+      changed = computeView(state, renderJob, renderScreenW, renderScreenH, renderScreenW >> 1, renderScreenH >> 1);
+      if (!renderCancel)
+      {
+        const u32 wallMicros = static_cast<u32>(ticks_to_microsecs(gettime() - renderStart));
+        const u32 loopMicros = frameLoopMicros - loopBefore;
+        lastRenderMicros = (wallMicros > loopMicros) ? wallMicros - loopMicros : 0;
+        updateGovernor(renderJob.interacting, lastRenderMicros);
+      }
+    }
+
+    // A job cancelled part way through the field leaves the view to start
+    // over, which keeps the frame loop off the field until one finishes
+    LWP_MutexLock(renderMutex);
+    renderChanged = renderChanged || changed;
+    renderBusy = false;
+    LWP_CondBroadcast(renderCond);
+  }
+  LWP_MutexUnlock(renderMutex);
+
+  return nullptr;
+}
+
+/**
+ * Starts the render thread for a screenW by screenH field. Without it the
+ * frame loop computes inline, as it does on the CPU path, which packs from the
+ * field every frame and so has nothing to show while a job owns it
+ */
+static void startRenderThread(MandelbrotState& state, int screenW, int screenH)
+{
+  renderScreenW = screenW;
+  renderScreenH = screenH;
+
+  if (LWP_MutexInit(&renderMutex, false) < 0)
+  {
+    return;
+  }
+
+  if (LWP_CondInit(&renderCond) < 0)
+  {
+    LWP_MutexDestroy(renderMutex);
+    return;
+  }
+
+  if (LWP_CreateThread(&renderThread, renderWorker, &state, nullptr, RENDER_STACK_SIZE, RENDER_PRIORITY) < 0)
+  {
+    LWP_CondDestroy(renderCond);
+    LWP_MutexDestroy(renderMutex);
+    renderThread = LWP_THREAD_NULL;
+  }
+}
+
 /**
  * Renders one frame into the given buffer, overlays the text and the pointer,
  * reads input, then presents the buffer. Quitting returns before the present,
@@ -656,6 +3872,29 @@ static bool handleInput(MandelbrotState& state, const WPADData* wd, int screenW2
  */
 static bool runFrame(MandelbrotState& state, u32* fb, int screenW, int screenH, int fbStride)
 {
+  frameLoopWoke = gettime();
+
+  // Written between frames, so the card's time shows as a gap in the trace
+  // rather than inflating a phase
+  if (state.traceRequested)
+  {
+    traceFile = ProfileWriteTrace();
+    state.traceRequested = false;
+  }
+
+  if (state.posterRequested)
+  {
+    startPoster(state, screenW, screenH);
+    state.posterRequested = false;
+  }
+
+  if (state.pathRequested)
+  {
+    startPath();
+    state.pathRequested = false;
+  }
+
+  ProfileBeginFrame();
   PalettePtr currentPalette = GetPalettePtr(state.paletteIndex);
 
   // Clear the top 20 pixels of the current buffer to prevent text smearing
@@ -663,11 +3902,48 @@ static bool runFrame(MandelbrotState& state, u32* fb, int screenW, int screenH,
   {
     fb[i] = COLOR_BLACK;
   }
+  ProfileMark(FramePhase::Clear);
   console_init(fb, 4, 0, rmode->fbWidth - 8, 20, fbStride);
+  ProfileMark(FramePhase::Console);
 
   u64 renderStart = gettime();
   renderMandelbrot(state, fb, currentPalette, screenW, screenH, screenW >> 1, screenH >> 1);
-  lastRenderMicros = static_cast<u32>(ticks_to_microsecs(gettime() - renderStart));
+  if (renderThread == LWP_THREAD_NULL)
+  {
+    lastRenderMicros = static_cast<u32>(ticks_to_microsecs(gettime() - renderStart));
+    updateGovernor(state.interacting(), lastRenderMicros);
+  }
+  ProfileMark(FramePhase::Draw);
+
+  // Without the thread a band is part of the frame, however long it takes
+  if (posterActive && renderThread == LWP_THREAD_NULL)
+  {
+    posterWritten = PosterRenderBand(poster);
+    if (!posterWritten || PosterDone(poster))
+    {
+      endPoster();
+    }
+    ProfileMark(FramePhase::Compute);
+  }
+  else if (pathActive && renderThread == LWP_THREAD_NULL)
+  {
+    ++pathFrame;
+    pathRendered = renderPathFrame();
+    if (!pathRendered || !ZoomPathWriteFrame(pathWriter, pathViews[pathFrame & 1], pathFields[pathFrame & 1]) ||
+      pathWriter.frames == zoomPath.frameCount)
+    {
+      endPath();
+    }
+    ProfileMark(FramePhase::Compute);
+  }
+
+  // A preview shows the old field scaled, which the heatmap would not line up
+  // with, and a field the render thread is still drawing may not match either
+  if (state.debugMode && state.debugPage == 5 && !state.previewing() && !renderBusy)
+  {
+    fieldHottestTile = tintCostHeatmap(fb, screenW, screenH, state.fieldLimit);
+    ProfileMark(FramePhase::Heatmap);
+  }
 
   if (state.cycling)
   {
@@ -677,22 +3953,81 @@ static bool runFrame(MandelbrotState& state, u32* fb, int screenW, int screenH,
   u32 type;
   WPAD_ReadPending(WPAD_CHAN_ALL, countevs);
   WPADData* wd = (WPAD_Probe(0, &type) == WPAD_ERR_NONE) ? WPAD_Data(0) : nullptr;
+  ProfileMark(FramePhase::Poll);
 
   updateDisplay(state, wd, screenW >> 1, screenH >> 1);
+  ProfileMark(FramePhase::Text);
 
   if (wd && wd->ir.valid)
   {
     drawdot(fb, rmode, static_cast<int>(wd->ir.x), static_cast<int>(wd->ir.y), COLOR_RED);
+    ProfileMark(FramePhase::Cursor);
   }
 
-  if (handleInput(state, wd, screenW >> 1, screenH >> 1))
+  if (posterActive || pathActive)
   {
-    return true;
+    // A poster or path holds the view still, so only cancelling it and
+    // quitting get through until it is done
+    if (wd && (wd->btns_d & WPAD_BUTTON_LEFT) && posterActive)
+    {
+      stopRender();
+      posterWritten = false;
+      endPoster();
+    }
+    else if (wd && (wd->btns_d & WPAD_BUTTON_LEFT))
+    {
+      stopRender();
+      pathRendered = false;
+      endPath();
+    }
+
+    if ((wd && (wd->btns_d & WPAD_BUTTON_HOME)) || reboot)
+    {
+      return true;
+    }
+  }
+  else
+  {
+    // Input that changes the view changes what the render thread is working
+    // from, so its job stops first. Everything else leaves it running
+    if (changesView(state, wd))
+    {
+      stopRender();
+    }
+
+    if (handleInput(state, wd, screenW >> 1, screenH >> 1))
+    {
+      return true;
+    }
+  }
+  ProfileMark(FramePhase::Input);
+
+  // The job computes while the loop waits for the flip. A held zoom moves the
+  // view every frame, so nothing starts until it lets go. Between two bands
+  // is where a poster is ended, and between two frames a path moves on
+  if (renderThread != LWP_THREAD_NULL && !renderBusy && (!state.zoomHeld || posterActive || pathActive))
+  {
+    if (posterActive && (!posterWritten || PosterDone(poster)))
+    {
+      endPoster();
+    }
+
+    if (pathActive)
+    {
+      advancePath();
+    }
+    else
+    {
+      takeRenderJob(state);
+      startRender();
+    }
   }
 
   VIDEO_SetNextFramebuffer(fb);
   VIDEO_Flush();
+  frameLoopSleeps();
   VIDEO_WaitVSync();
+  ProfileMark(FramePhase::Present);
 
   return false;
 }
@@ -712,17 +4047,28 @@ int main(int argc, char** argv)
   const int fbStride = ((rmode->fbWidth * VI_DISPLAY_PIX_SZ) + 31) & ~31;
   const int screenW = fbStride / VI_DISPLAY_PIX_SZ;
   const int screenH = rmode->xfbHeight;
-  field = static_cast<int*>(aligned_alloc(32, ALIGN32(sizeof(int) * screenW * screenH)));
+  field = static_cast<FieldCount*>(aligned_alloc(32, ALIGN32(sizeof(FieldCount) * screenW * screenH)));
+  const int tilesDown = (screenH - FIELD_TOP + FIELD_TILE - 1) / FIELD_TILE;
+  fieldTiles = static_cast<FieldTile*>(malloc(sizeof(FieldTile) * FieldTilesAcross(screenW) * tilesDown));
 
-  if (!field)
+  if (!field || !fieldTiles)
   {
     fatalError("Not enough memory for the iteration buffer.");
     return 1;
   }
 
+  // A mode whose field does not tile, or no memory for the FIFO, leaves the
+  // colouring to the CPU
+  gxPalette = GXDisplayInit(rmode, screenW, screenH, FIELD_TOP);
+
   MandelbrotState state;
   bool bufferIndex = 0;
 
+  if (gxPalette)
+  {
+    startRenderThread(state, screenW, screenH);
+  }
+
   do
   {
     bufferIndex = !bufferIndex;
@@ -0,0 +1,353 @@
+// src/poster.cpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#include "poster.hpp"
+#include "render.hpp"
+
+#include <algorithm> // For std::min, std::max
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+  // Pixel spacing, in double steps at the view's scale, below which doubles
+  // stop telling pixels apart. The screen moves to double-double there, and
+  // a poster straight to perturbation, which holds at any depth
+  constexpr double DEEP_SPACING_ULPS = 1024.0;
+
+  // Bytes in one stored deflate block at most
+  constexpr size_t STORED_BLOCK = 65535;
+
+  // Largest run of bytes whose Adler-32 sums cannot overflow before the modulo
+  constexpr size_t ADLER_RUN = 5552;
+
+  uint32_t crcTable[256];
+  bool crcReady = false;
+
+  void buildCrcTable()
+  {
+    for (uint32_t n = 0; n < 256; ++n)
+    {
+      uint32_t c = n;
+      for (int k = 0; k < 8; ++k)
+      {
+        c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+      }
+      crcTable[n] = c;
+    }
+    crcReady = true;
+  }
+
+  uint32_t crcUpdate(uint32_t crc, const uint8_t* data, size_t length)
+  {
+    for (size_t i = 0; i < length; ++i)
+    {
+      crc = crcTable[(crc ^ data[i]) & 255] ^ (crc >> 8);
+    }
+    return crc;
+  }
+
+  uint32_t adlerUpdate(uint32_t adler, const uint8_t* data, size_t length)
+  {
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+
+    while (length > 0)
+    {
+      const size_t run = std::min(length, ADLER_RUN);
+      for (size_t i = 0; i < run; ++i)
+      {
+        a += data[i];
+        b += a;
+      }
+      a %= 65521;
+      b %= 65521;
+      data += run;
+      length -= run;
+    }
+
+    return (b << 16) | a;
+  }
+
+  inline void put32(uint8_t* out, uint32_t value)
+  {
+    out[0] = static_cast<uint8_t>(value >> 24);
+    out[1] = static_cast<uint8_t>(value >> 16);
+    out[2] = static_cast<uint8_t>(value >> 8);
+    out[3] = static_cast<uint8_t>(value);
+  }
+
+  // Writes bytes and folds them into the CRC of the chunk they belong to
+  bool writeCrc(FILE* out, const uint8_t* data, size_t length, uint32_t& crc)
+  {
+    crc = crcUpdate(crc, data, length);
+    return fwrite(data, 1, length, out) == length;
+  }
+
+  // Starts a PNG chunk of length bytes. Its CRC covers the type and the data
+  bool beginChunk(FILE* out, const char* type, size_t length, uint32_t& crc)
+  {
+    uint8_t head[8];
+    put32(head, static_cast<uint32_t>(length));
+    memcpy(head + 4, type, 4);
+    crc = 0xFFFFFFFFu;
+    return fwrite(head, 1, 4, out) == 4 && writeCrc(out, head + 4, 4, crc);
+  }
+
+  bool endChunk(FILE* out, uint32_t crc)
+  {
+    uint8_t tail[4];
+    put32(tail, crc ^ 0xFFFFFFFFu);
+    return fwrite(tail, 1, 4, out) == 4;
+  }
+
+  bool writeChunk(FILE* out, const char* type, const uint8_t* data, size_t length)
+  {
+    uint32_t crc;
+    return beginChunk(out, type, length, crc) && writeCrc(out, data, length, crc) && endChunk(out, crc);
+  }
+
+  /**
+   * Writes data as one IDAT chunk of stored deflate blocks, none of them the
+   * last. Compressing would need a band's worth of zlib state for a few
+   * percent on a picture this noisy, so the blocks only frame the bytes
+   */
+  bool writeStored(FILE* out, const uint8_t* data, size_t length)
+  {
+    const size_t blocks = (length + STORED_BLOCK - 1) / STORED_BLOCK;
+    uint32_t crc;
+    bool ok = beginChunk(out, "IDAT", length + (5 * blocks), crc);
+
+    for (size_t at = 0; ok && at < length; at += STORED_BLOCK)
+    {
+      const size_t size = std::min(STORED_BLOCK, length - at);
+      const uint8_t head[5] = {
+        0,
+        static_cast<uint8_t>(size), static_cast<uint8_t>(size >> 8),
+        static_cast<uint8_t>(~size), static_cast<uint8_t>(~size >> 8)
+      };
+      ok = writeCrc(out, head, sizeof(head), crc) && writeCrc(out, data + at, size, crc);
+    }
+
+    return ok && endChunk(out, crc);
+  }
+
+  inline uint8_t clampChannel(int value)
+  {
+    return static_cast<uint8_t>(std::min(255, std::max(0, value)));
+  }
+
+  // The palettes hold video range YUV, so this is the BT.601 matrix the GX
+  // path uses to build its lookup table, at full eight bits a channel
+  void yuvToRgb(const uint8_t* yuv, uint8_t* rgb)
+  {
+    const int y = 298 * (yuv[0] - 16);
+    const int u = yuv[1] - 128;
+    const int v = yuv[2] - 128;
+
+    rgb[0] = clampChannel((y + 409 * v + 128) >> 8);
+    rgb[1] = clampChannel((y - 100 * u - 208 * v + 128) >> 8);
+    rgb[2] = clampChannel((y + 516 * u + 128) >> 8);
+  }
+}  // namespace
+
+bool PosterBegin(PosterJob& job, const PosterView& view, FILE* out, bool ppm)
+{
+  job.field = nullptr;
+  job.pixels = nullptr;
+
+  if (view.width <= 0 || view.height <= 0 || (view.width & 1) != 0)
+  {
+    return false;
+  }
+
+  const size_t rowBytes = 1 + (3 * static_cast<size_t>(view.width));
+  const size_t bandRowBytes = (sizeof(FieldCount) * view.width) + rowBytes;
+  job.view = view;
+  job.out = out;
+  job.png = !ppm;
+  job.bandRows = static_cast<int>(std::min<size_t>(view.height, std::max<size_t>(1, POSTER_BAND_BYTES / bandRowBytes)));
+  job.row = 0;
+  job.adler = 1;
+  job.field = static_cast<FieldCount*>(malloc(sizeof(FieldCount) * view.width * job.bandRows));
+  job.pixels = static_cast<uint8_t*>(malloc(rowBytes * job.bandRows));
+
+  if (!job.field || !job.pixels)
+  {
+    PosterAbort(job);
+    return false;
+  }
+
+  job.deep = PosterNeedsDeep(view);
+
+  for (int i = 0; i < 256; ++i)
+  {
+    yuvToRgb(view.palette[(i + view.cycle) & 255], job.rgb[i]);
+  }
+  yuvToRgb(Black, job.rgb[256]);
+
+  if (ppm)
+  {
+    return fprintf(out, "P6\n%d %d\n255\n", view.width, view.height) > 0;
+  }
+
+  if (!crcReady)
+  {
+    buildCrcTable();
+  }
+
+  // Eight bits a channel of RGB, no interlacing. The zlib header asks for no
+  // preset dictionary and says nothing useful about the level, since every
+  // block is stored
+  static const uint8_t Signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+  uint8_t header[13];
+  put32(header, static_cast<uint32_t>(view.width));
+  put32(header + 4, static_cast<uint32_t>(view.height));
+  header[8] = 8;
+  header[9] = 2;
+  header[10] = 0;
+  header[11] = 0;
+  header[12] = 0;
+  static const uint8_t ZlibHeader[2] = {0x78, 0x01};
+
+  return fwrite(Signature, 1, sizeof(Signature), out) == sizeof(Signature)
+    && writeChunk(out, "IHDR", header, sizeof(header))
+    && writeChunk(out, "IDAT", ZlibHeader, sizeof(ZlibHeader));
+}
+
+bool PosterNeedsDeep(const PosterView& view)
+{
+  const double scale = std::min(2.0, std::max({1.0, std::fabs(BigFixedToDouble(view.centerRe)),
+    std::fabs(BigFixedToDouble(view.centerIm))}));
+  return view.spacing < DEEP_SPACING_ULPS * DBL_EPSILON * scale;
+}
+
+bool PosterRenderRows(const PosterView& view, bool deep, int row, int rows, FieldCount* field)
+{
+  const int centerCol = view.width >> 1;
+  const int centerRow = view.height >> 1;
+
+  if (deep)
+  {
+    // The rows are a short view of their own, centred on their middle row so
+    // the series sees offsets no larger than theirs
+    DeepView band;
+    band.centerRe = view.centerRe;
+    band.centerIm = BigFixedAdd(view.centerIm,
+      BigFixedFromDouble(-(row + (rows >> 1) - centerRow) * view.spacing));
+    band.zoom = view.spacing;
+    band.limit = view.limit;
+    band.width = view.width;
+    band.top = 0;
+    band.height = rows;
+    band.centerCol = centerCol;
+    band.centerRow = rows >> 1;
+    band.cancel = view.cancel;
+
+    DeepStats stats;
+    if (!RenderDeepField(band, field, stats))
+    {
+      return false;
+    }
+  }
+  else
+  {
+    const double rowStart = BigFixedToDouble(view.centerRe) - centerCol * view.spacing;
+    const double centerIm = BigFixedToDouble(view.centerIm);
+    for (int r = 0; r < rows && !(view.cancel && *view.cancel); ++r)
+    {
+      const double ci = centerIm - (row + r - centerRow) * view.spacing;
+      RenderRow(field + (view.width * r), view.width, rowStart, view.spacing, ci, view.limit, false);
+    }
+  }
+
+  return !(view.cancel && *view.cancel);
+}
+
+bool PosterWriteRows(PosterJob& job, const FieldCount* field, int rows)
+{
+  const PosterView& view = job.view;
+  const size_t rowBytes = 1 + (3 * static_cast<size_t>(view.width));
+  bool written = true;
+
+  // The pixels take a band at a time, however many rows come in
+  for (int done = 0; written && done < rows; done += job.bandRows)
+  {
+    const int band = std::min(job.bandRows, rows - done);
+
+    // A count of exactly the limit never escaped and takes the interior colour
+    for (int r = 0; r < band; ++r)
+    {
+      const FieldCount* rowField = field + (view.width * (done + r));
+      uint8_t* line = job.pixels + (rowBytes * r);
+      *line++ = 0;
+
+      for (int x = 0; x < view.width; ++x)
+      {
+        const int n = rowField[x];
+        memcpy(line, job.rgb[(n == view.limit) ? 256 : (n & 255)], 3);
+        line += 3;
+      }
+    }
+
+    if (job.png)
+    {
+      job.adler = adlerUpdate(job.adler, job.pixels, rowBytes * band);
+      written = writeStored(job.out, job.pixels, rowBytes * band);
+    }
+    else
+    {
+      for (int r = 0; written && r < band; ++r)
+      {
+        written = fwrite(job.pixels + (rowBytes * r) + 1, 1, rowBytes - 1, job.out) == rowBytes - 1;
+      }
+    }
+
+    job.row += band;
+  }
+
+  return written;
+}
+
+bool PosterRenderBand(PosterJob& job)
+{
+  const int rows = std::min(job.bandRows, job.view.height - job.row);
+  return PosterRenderRows(job.view, job.deep, job.row, rows, job.field) && PosterWriteRows(job, job.field, rows);
+}
+
+bool PosterFinish(PosterJob& job)
+{
+  bool written = true;
+
+  if (job.png)
+  {
+    // An empty stored block closes the deflate stream, and the checksum of
+    // everything it held closes the zlib one
+    uint8_t trailer[9] = {1, 0, 0, 0xFF, 0xFF};
+    put32(trailer + 5, job.adler);
+    written = writeChunk(job.out, "IDAT", trailer, sizeof(trailer)) && writeChunk(job.out, "IEND", nullptr, 0);
+  }
+
+  PosterAbort(job);
+  return written;
+}
+
+void PosterAbort(PosterJob& job)
+{
+  free(job.field);
+  job.field = nullptr;
+  free(job.pixels);
+  job.pixels = nullptr;
+}
+
+// EOF
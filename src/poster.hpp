@@ -0,0 +1,120 @@
+// src/poster.hpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef POSTER_HPP
+#define POSTER_HPP
+
+// Renders a view far larger than the screen a band of rows at a time, colours
+// each band and streams it to a PNG or PPM file, so only one band is ever in
+// memory. Like the render core it needs nothing from libogc, and the host
+// tool in bench/ renders posters through the very same code
+
+#include "deepzoom.hpp"
+#include "field.hpp"
+#include "palettes.hpp"
+
+#include <cstdint>
+#include <cstdio>
+
+// Memory a band may take, its counts and its colours together
+static constexpr int POSTER_BAND_BYTES = 1 << 20;
+
+// What a poster shows: the view centred on (centerRe, centerIm) with pixels
+// spacing apart, coloured the way the screen colours it
+struct PosterView
+{
+  BigFixed centerRe;
+  BigFixed centerIm;
+  double spacing;
+  int limit;
+  // The row kernel takes pixels in pairs, so the width has to be even
+  int width;
+  int height;
+  PalettePtr palette;
+  int cycle;
+  // Stops the band being rendered at the next row once set. Null when
+  // nothing will cancel it
+  const volatile bool* cancel;
+};
+
+// A poster being written. Rows before row are in the file already
+struct PosterJob
+{
+  PosterView view;
+  FILE* out;
+  bool png;
+  bool deep;
+  int bandRows;
+  int row;
+  FieldCount* field;
+  // A filter byte and the colours of each row, the layout PNG wants
+  uint8_t* pixels;
+  uint32_t adler;
+  // The palette after the rotation, and the interior's colour after it
+  uint8_t rgb[257][3];
+};
+
+/**
+ * Sets up a poster of view and writes the file's header to out, as PNG or
+ * with ppm as a binary PPM
+ *
+ * @return False when the width is odd, there was no memory for a band, or the
+ * header could not be written
+ */
+bool PosterBegin(PosterJob& job, const PosterView& view, FILE* out, bool ppm);
+
+// Whether doubles are too coarse for the view's pixel spacing, so that only
+// perturbation can render it
+bool PosterNeedsDeep(const PosterView& view);
+
+/**
+ * Renders rows row to row + rows of view into field, which holds just those
+ * rows, by perturbation when deep is set
+ *
+ * @return False when the view was cancelled or there was no memory for the
+ * reference orbit
+ */
+bool PosterRenderRows(const PosterView& view, bool deep, int row, int rows, FieldCount* field);
+
+/**
+ * Colours rows rows of field and appends them to the file, for a caller that
+ * renders the counts itself
+ *
+ * @return False when they could not be written
+ */
+bool PosterWriteRows(PosterJob& job, const FieldCount* field, int rows);
+
+/**
+ * Renders the next band and appends it to the file
+ *
+ * @return False when the band was cancelled or could not be written
+ */
+bool PosterRenderBand(PosterJob& job);
+
+static inline bool PosterDone(const PosterJob& job)
+{
+  return job.row >= job.view.height;
+}
+
+/**
+ * Ends the file once every band is in, and frees the job's buffers. The file
+ * is the caller's to close
+ *
+ * @return False when the end could not be written
+ */
+bool PosterFinish(PosterJob& job);
+
+// Frees the job's buffers without ending the file
+void PosterAbort(PosterJob& job);
+
+#endif // POSTER_HPP
+
+// EOF
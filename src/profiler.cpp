@@ -0,0 +1,141 @@
+// src/profiler.cpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#include "profiler.hpp"
+#include "sdcard.hpp"
+
+#include <algorithm> // For std::min
+#include <cstdio>
+#include <ogc/lwp_watchdog.h>
+
+namespace
+{
+  const char* const PhaseNames[FRAME_PHASE_COUNT] = {
+    "Clear", "Console", "Compute", "Draw", "Heatmap",
+    "Poll", "Text", "Cursor", "Input", "Present"
+  };
+
+  // Ticks rather than microseconds, so a frame costs a subtraction per mark.
+  // No phase comes near the minute a 32-bit count of them lasts
+  struct FrameSample
+  {
+    u64 start;
+    u32 ticks[FRAME_PHASE_COUNT];
+  };
+
+  FrameSample frames[PROFILE_FRAMES];
+  int head = -1;
+  int begun = 0;
+  u64 lastMark = 0;
+
+  // Frames in the ring that have closed, and where the oldest of them is
+  int closedFrames()
+  {
+    return std::min(begun - 1, PROFILE_FRAMES - 1);
+  }
+
+  int oldestFrame()
+  {
+    return (head - closedFrames() + PROFILE_FRAMES) % PROFILE_FRAMES;
+  }
+
+  double ticksToMicros(u64 ticks)
+  {
+    return ticks_to_nanosecs(ticks) / 1000.0;
+  }
+}  // namespace
+
+void ProfileBeginFrame()
+{
+  head = (head + 1) % PROFILE_FRAMES;
+  begun = std::min(begun + 1, PROFILE_FRAMES);
+  lastMark = gettime();
+
+  FrameSample& frame = frames[head];
+  frame.start = lastMark;
+  for (int p = 0; p < FRAME_PHASE_COUNT; ++p)
+  {
+    frame.ticks[p] = 0;
+  }
+}
+
+void ProfileMark(FramePhase phase)
+{
+  const u64 now = gettime();
+  frames[head].ticks[static_cast<int>(phase)] += static_cast<u32>(now - lastMark);
+  lastMark = now;
+}
+
+int ProfileTimes(u32* out, int phase)
+{
+  const int count = closedFrames();
+  int index = oldestFrame();
+
+  for (int i = 0; i < count; ++i)
+  {
+    const int next = (index + 1) % PROFILE_FRAMES;
+    const u64 ticks = (phase < 0) ? frames[next].start - frames[index].start : frames[index].ticks[phase];
+    out[i] = ticks_to_microsecs(ticks);
+    index = next;
+  }
+
+  return count;
+}
+
+int ProfileWriteTrace()
+{
+  int number;
+  FILE* out = SDCreateNumbered("sd:/wmcpp-trace-%02d.json", number);
+  if (!out)
+  {
+    return -1;
+  }
+
+  const int count = closedFrames();
+  int index = oldestFrame();
+  const u64 origin = frames[index].start;
+  bool first = true;
+
+  // Complete events on one thread nest by time, so each frame's phases show
+  // under it and any gap between them is time no mark accounted for
+  fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+  for (int i = 0; i < count; ++i)
+  {
+    const FrameSample& frame = frames[index];
+    const double start = ticksToMicros(frame.start - origin);
+    const u64 end = frames[(index + 1) % PROFILE_FRAMES].start;
+
+    fprintf(out, "%s{\"name\":\"Frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+      first ? "" : ",\n", start, ticksToMicros(end - frame.start));
+    first = false;
+
+    double at = start;
+    for (int p = 0; p < FRAME_PHASE_COUNT; ++p)
+    {
+      if (frame.ticks[p] == 0)
+      {
+        continue;
+      }
+
+      const double length = ticksToMicros(frame.ticks[p]);
+      fprintf(out, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+        PhaseNames[p], at, length);
+      at += length;
+    }
+    index = (index + 1) % PROFILE_FRAMES;
+  }
+  fprintf(out, "\n]}\n");
+
+  const bool written = !ferror(out);
+  return (fclose(out) == 0 && written) ? number : -1;
+}
+
+// EOF
@@ -0,0 +1,68 @@
+// src/profiler.hpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <gccore.h>
+
+// Times every phase of the last PROFILE_FRAMES frames with the timebase. A
+// frame opens with ProfileBeginFrame, and each ProfileMark closes a phase,
+// charging it with the time since the mark before. A phase that never gets
+// marked in a frame took no time in it
+
+// The phases of a frame, in the order they run
+enum class FramePhase
+{
+  Clear,
+  Console,
+  Compute,
+  Draw,
+  Heatmap,
+  Poll,
+  Text,
+  Cursor,
+  Input,
+  Present
+};
+
+static constexpr int FRAME_PHASE_COUNT = 10;
+
+// Frames the ring holds, a little over eight seconds at 60 Hz
+static constexpr int PROFILE_FRAMES = 512;
+
+void ProfileBeginFrame();
+void ProfileMark(FramePhase phase);
+
+/**
+ * Copies how long each frame in the ring took, or one phase of it, in
+ * microseconds and oldest first. A whole frame runs from its start to the
+ * next one's, so it counts time between frames too. The frame still open is
+ * left out
+ *
+ * @param phase The phase to copy, or -1 for whole frames
+ * @return Number of frames copied, up to PROFILE_FRAMES - 1
+ */
+int ProfileTimes(u32* out, int phase);
+
+/**
+ * Writes the ring to the SD card as a Chrome trace, one event per frame with
+ * its phases nested under it, for chrome://tracing or Perfetto to open. The
+ * card is mounted on first use, and the file takes the first free name from
+ * sd:/wmcpp-trace-00.json to sd:/wmcpp-trace-99.json
+ *
+ * @return The number in the file name, or -1 if nothing could be written
+ */
+int ProfileWriteTrace();
+
+#endif // PROFILER_HPP
+
+// EOF
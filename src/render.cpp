@@ -0,0 +1,151 @@
+// src/render.cpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+// Portions Copyright (C) 2011 Krupkat <krupkat@seznam.cz>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#include "render.hpp"
+#include "kernel.hpp"
+
+#include <algorithm> // For std::min
+
+uint32_t RenderRow(FieldCount* rowField, int width, double rowStart, double zoom, double ci, int limit, bool single)
+{
+  const double ciSquared = ci * ci; // Calculate once per row
+  uint32_t rowSum = 0;
+  int w = 0;
+
+  do
+  {
+    // Each coordinate comes from its own column rather than a running sum, so
+    // every engine lands on exactly the same point for the same pixel and the
+    // counts can be compared between them. The pair kernel iterates both at once
+    int n1;
+    int n2;
+    computePair(single, rowStart + w * zoom, rowStart + (w + 1) * zoom, ci, ciSquared, limit, n1, n2);
+    rowField[w] = static_cast<FieldCount>(n1);
+    rowField[w + 1] = static_cast<FieldCount>(n2);
+    rowSum += static_cast<uint32_t>(n1 + n2);
+    w += 2;
+  } while (w < width);
+
+  return rowSum;
+}
+
+void PackField(
+  const FieldCount* field,
+  const FieldTile* tiles,
+  uint32_t* framebuffer,
+  int width,
+  int top,
+  int height,
+  int limit,
+  int cycle,
+  PalettePtr palette)
+{
+  const int across = FieldTilesAcross(width);
+
+  int h = top;
+  do
+  {
+    int widthH = width * h;
+
+    // Draw pixels to XFB
+    const FieldCount* rowField = field + widthH;
+    uint32_t* rowXfb = framebuffer + (widthH >> 1);
+    const FieldTile* rowTiles = tiles + (((h - top) / FIELD_TILE) * across);
+
+    for (int tx = 0; tx < across; ++tx)
+    {
+      const int x0 = tx * FIELD_TILE;
+      const int x1 = std::min(x0 + FIELD_TILE, width);
+
+      if (rowTiles[tx].min == rowTiles[tx].max)
+      {
+        const uint32_t word = PackYUVPair(rowTiles[tx].min, rowTiles[tx].min, limit, cycle, palette);
+        for (int w = x0; w < x1; w += 2)
+        {
+          rowXfb[w >> 1] = word;
+        }
+        continue;
+      }
+
+      for (int w = x0; w < x1; w += 2)
+      {
+        // Retrieve iteration counts using pointer arithmetic
+        int n1 = rowField[w];
+        int n2 = rowField[w + 1];
+        // Write to XFB using pointer arithmetic
+        rowXfb[w >> 1] = PackYUVPair(n1, n2, limit, cycle, palette);
+      }
+    }
+
+  } while (++h < height);
+}
+
+void BlendFieldEdge(const FieldEdge& edge, int limit, int cycle, PalettePtr palette, uint8_t* yuv)
+{
+  int sum[3] = {0, 0, 0};
+  for (int i = 0; i < edge.samples; ++i)
+  {
+    const int n = edge.counts[i];
+    const uint8_t* p = (n == limit) ? Black : palette[(n + cycle) & 255];
+    sum[0] += p[0];
+    sum[1] += p[1];
+    sum[2] += p[2];
+  }
+
+  const int half = edge.samples >> 1;
+  for (int c = 0; c < 3; ++c)
+  {
+    yuv[c] = static_cast<uint8_t>((sum[c] + half) / edge.samples);
+  }
+}
+
+void PackFieldEdges(
+  const FieldCount* field,
+  const FieldEdge* edges,
+  int count,
+  uint32_t* framebuffer,
+  int limit,
+  int cycle,
+  PalettePtr palette)
+{
+  for (int i = 0; i < count; ++i)
+  {
+    // The width is even, so an even offset starts a pair and an odd one ends it
+    const uint32_t offset = edges[i].offset;
+    const uint32_t left = offset & ~1u;
+    uint8_t blended[3];
+    uint8_t other[3];
+    const uint8_t* p1 = blended;
+    const uint8_t* p2 = blended;
+    BlendFieldEdge(edges[i], limit, cycle, palette, blended);
+
+    if (offset & 1u)
+    {
+      const int n = field[left];
+      p1 = (n == limit) ? Black : palette[(n + cycle) & 255];
+    }
+    else if (i + 1 < count && edges[i + 1].offset == offset + 1)
+    {
+      BlendFieldEdge(edges[++i], limit, cycle, palette, other);
+      p2 = other;
+    }
+    else
+    {
+      const int n = field[offset + 1];
+      p2 = (n == limit) ? Black : palette[(n + cycle) & 255];
+    }
+
+    framebuffer[left >> 1] = PackYUVColours(p1, p2);
+  }
+}
+
+// EOF
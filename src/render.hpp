@@ -0,0 +1,108 @@
+// src/render.hpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+// Portions Copyright (C) 2011 Krupkat <krupkat@seznam.cz>
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef RENDER_HPP
+#define RENDER_HPP
+
+// The row renderer and the CPU pack stage. Like the kernels they need nothing
+// from libogc, so the host benchmark in bench/ times the very code the Wii runs
+
+#include "field.hpp"
+#include "palettes.hpp"
+
+#include <cstdint>
+
+// Color constant for points inside the set (Black in YUV: Y=0, U=128, V=128)
+static const uint8_t Black[3] = {0, 128, 128};
+
+/**
+ * Packs two YUV colours side by side into one framebuffer word, Y1, average U,
+ * Y2, average V
+ */
+static inline uint32_t PackYUVColours(const uint8_t* p1, const uint8_t* p2)
+{
+  return (p1[0] << 24) | ((p1[1] + p2[1]) >> 1 << 16) | (p2[0] << 8) | ((p1[2] + p2[2]) >> 1);
+}
+
+/**
+ * Packs two adjacent pixels' YUV values into the Wii's native framebuffer format.
+ * The Wii uses an interleaved YUV format where two pixels share chrominance (U,V)
+ * values to save memory bandwidth. The resulting 32-bit value contains two Y
+ * (luminance) values with shared U and V components between adjacent pixels.
+ *
+ * @param n1 First pixel's iteration count
+ * @param n2 Second pixel's iteration count
+ * @param limit Maximum iteration count
+ * @param cycle Palette rotation offset, applied only to points that escaped
+ * @param palette Current color palette pointer
+ * @return Packed 32-bit YUV value ready for framebuffer
+ */
+static inline uint32_t PackYUVPair(int n1, int n2, int limit, int cycle, PalettePtr palette)
+{
+  // A count of exactly limit means the point never escaped and belongs to the
+  // set, so it stays black and only the escape counts take the rotation
+  const uint8_t* p1 = (n1 == limit) ? Black : palette[(n1 + cycle) & 255];
+  const uint8_t* p2 = (n2 == limit) ? Black : palette[(n2 + cycle) & 255];
+
+  return PackYUVColours(p1, p2);
+}
+
+/**
+ * Renders a single row of an even width, two pixels at a time through the
+ * pair kernel. Column w sits at rowStart + w * zoom, and single picks the
+ * float kernel over the double one
+ *
+ * @return Total iteration count across the row, for the debug strip's average
+ */
+uint32_t RenderRow(FieldCount* rowField, int width, double rowStart, double zoom, double ci, int limit, bool single);
+
+/**
+ * Packs rows top to height of a width-wide field into framebuffer words, two
+ * pixels each, with the field's tile summaries already up to date. A tile of
+ * a single count packs once and repeats the word across the tile
+ */
+void PackField(
+  const FieldCount* field,
+  const FieldTile* tiles,
+  uint32_t* framebuffer,
+  int width,
+  int top,
+  int height,
+  int limit,
+  int cycle,
+  PalettePtr palette);
+
+/**
+ * Averages the colours of an edge's samples into yuv, coloured the way
+ * PackYUVPair colours a count. The edge has to have been sampled
+ */
+void BlendFieldEdge(const FieldEdge& edge, int limit, int cycle, PalettePtr palette, uint8_t* yuv);
+
+/**
+ * Packs the framebuffer words of count sampled edges again over what
+ * PackField wrote, each edge's own pixel blended from its samples and the
+ * other pixel of the pair blended too if it is the next edge, or taken from
+ * the field if not. Blending before the pair shares its U and V keeps the
+ * result what packing a supersampled field would give
+ */
+void PackFieldEdges(
+  const FieldCount* field,
+  const FieldEdge* edges,
+  int count,
+  uint32_t* framebuffer,
+  int limit,
+  int cycle,
+  PalettePtr palette);
+
+#endif // RENDER_HPP
+
+// EOF
@@ -0,0 +1,52 @@
+// src/sdcard.cpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#include "sdcard.hpp"
+
+#include <fat.h>
+
+namespace
+{
+  bool mounted = false;
+}  // namespace
+
+bool SDMount()
+{
+  if (!mounted)
+  {
+    mounted = fatInitDefault();
+  }
+  return mounted;
+}
+
+FILE* SDCreateNumbered(const char* pattern, int& number)
+{
+  if (!SDMount())
+  {
+    return nullptr;
+  }
+
+  char path[64];
+  for (number = 0; number < SD_NUMBERED_FILES; ++number)
+  {
+    snprintf(path, sizeof(path), pattern, number);
+    FILE* existing = fopen(path, "rb");
+    if (!existing)
+    {
+      return fopen(path, "wb");
+    }
+    fclose(existing);
+  }
+
+  return nullptr;
+}
+
+// EOF
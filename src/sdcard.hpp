@@ -0,0 +1,36 @@
+// src/sdcard.hpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef SDCARD_HPP
+#define SDCARD_HPP
+
+#include <cstdio>
+
+// Numbered names SDCreateNumbered tries before giving up
+static constexpr int SD_NUMBERED_FILES = 100;
+
+// Mounts the card on first use. Returns false when there is none to mount
+bool SDMount();
+
+/**
+ * Creates the first file of pattern's numbered names that does not exist yet,
+ * so nothing written earlier is overwritten. pattern holds one %02d, which
+ * counts from 0 to SD_NUMBERED_FILES - 1. The card is mounted on first use
+ *
+ * @param number Set to the number in the name created
+ * @return The file opened for binary writing, or null if there was no card,
+ * no free name, or the file could not be created
+ */
+FILE* SDCreateNumbered(const char* pattern, int& number);
+
+#endif // SDCARD_HPP
+
+// EOF
@@ -0,0 +1,299 @@
+// src/zoompath.cpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#include "zoompath.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+  constexpr int DEFAULT_WIDTH = 640;
+  constexpr int DEFAULT_HEIGHT = 480;
+  constexpr int DEFAULT_RATE = 30;
+  constexpr int MAX_SIDE = 8192;
+  constexpr int MAX_RATE = 240;
+  constexpr int LINE_SIZE = 2 * BIGFIXED_TEXT_SIZE + 96;
+
+  // The interior in video range YUV, the black the screen shows
+  constexpr uint8_t INTERIOR_YUV[3] = {16, 128, 128};
+
+  bool parseKey(const char* line, ZoomKey& key)
+  {
+    char re[BIGFIXED_TEXT_SIZE];
+    char im[BIGFIXED_TEXT_SIZE];
+    static_assert(BIGFIXED_TEXT_SIZE == 86, "The scan widths below assume 85 characters");
+
+    if (sscanf(line, "key %85s %85s %lf %d %d %d", re, im, &key.spacing, &key.limit, &key.palette, &key.frames) != 6)
+    {
+      return false;
+    }
+
+    return BigFixedFromString(re, key.centerRe) && BigFixedFromString(im, key.centerIm) && key.spacing > 0.0 &&
+      std::isfinite(key.spacing) && key.limit > 0 && key.palette >= 0 && key.palette < GetPaletteCount() &&
+      key.frames > 0;
+  }
+
+  // Parses one line, which has had its comment cut off
+  bool parseLine(const char* line, ZoomPath& path)
+  {
+    while (*line == ' ' || *line == '\t' || *line == '\r')
+    {
+      ++line;
+    }
+
+    if (*line == '\0')
+    {
+      return true;
+    }
+
+    if (strncmp(line, "size ", 5) == 0)
+    {
+      return sscanf(line, "size %d %d", &path.width, &path.height) == 2 && path.width > 0 && path.width <= MAX_SIDE &&
+        (path.width & 1) == 0 && path.height > 0 && path.height <= MAX_SIDE;
+    }
+
+    if (strncmp(line, "rate ", 5) == 0)
+    {
+      return sscanf(line, "rate %d", &path.rate) == 1 && path.rate > 0 && path.rate <= MAX_RATE;
+    }
+
+    if (strncmp(line, "key ", 4) == 0)
+    {
+      return path.keyCount < ZOOM_PATH_KEYS && parseKey(line, path.keys[path.keyCount++]);
+    }
+
+    return false;
+  }
+
+  bool writeAll(ZoomPathWriter& writer, const void* data, size_t size)
+  {
+    if (fwrite(data, 1, size, writer.stream) != size)
+    {
+      return false;
+    }
+    writer.bytes += size;
+    return true;
+  }
+
+  bool writeStreamFrame(ZoomPathWriter& writer, const PosterView& view, const FieldCount* field)
+  {
+    static const char FRAME[] = "FRAME\n";
+    const int pixels = writer.width * writer.height;
+    uint8_t* y = writer.planes;
+    uint8_t* u = y + pixels;
+    uint8_t* v = u + pixels;
+
+    for (int i = 0; i < pixels; ++i)
+    {
+      const int n = field[i];
+      const uint8_t* yuv = (n >= view.limit) ? INTERIOR_YUV : view.palette[(n + view.cycle) & 255];
+      y[i] = yuv[0];
+      u[i] = yuv[1];
+      v[i] = yuv[2];
+    }
+
+    return writeAll(writer, FRAME, sizeof(FRAME) - 1) && writeAll(writer, writer.planes, 3 * static_cast<size_t>(pixels));
+  }
+
+  bool writeImageFrame(ZoomPathWriter& writer, const PosterView& view, const FieldCount* field)
+  {
+    char name[sizeof(writer.pattern) + 16];
+    snprintf(name, sizeof(name), writer.pattern, writer.frames);
+
+    FILE* out = fopen(name, "wb");
+    if (!out)
+    {
+      return false;
+    }
+
+    PosterJob job;
+    bool written = PosterBegin(job, view, out, writer.format == ZoomPathFormat::Ppm);
+    if (written)
+    {
+      written = PosterWriteRows(job, field, view.height);
+      written = PosterFinish(job) && written;
+    }
+
+    const long size = ftell(out);
+    written = (fclose(out) == 0) && written;
+    if (written && size > 0)
+    {
+      writer.bytes += static_cast<uint64_t>(size);
+    }
+    return written;
+  }
+}  // namespace
+
+int ZoomPathParse(const char* text, ZoomPath& path)
+{
+  path.width = DEFAULT_WIDTH;
+  path.height = DEFAULT_HEIGHT;
+  path.rate = DEFAULT_RATE;
+  path.keyCount = 0;
+  path.frameCount = 0;
+
+  int lineNumber = 0;
+  while (*text != '\0')
+  {
+    ++lineNumber;
+    const char* end = strchr(text, '\n');
+    const size_t length = end ? static_cast<size_t>(end - text) : strlen(text);
+
+    char line[LINE_SIZE];
+    if (length >= sizeof(line))
+    {
+      return lineNumber;
+    }
+    memcpy(line, text, length);
+    line[length] = '\0';
+
+    char* comment = strchr(line, '#');
+    if (comment)
+    {
+      *comment = '\0';
+    }
+
+    if (!parseLine(line, path))
+    {
+      return lineNumber;
+    }
+
+    text += length;
+    if (*text == '\n')
+    {
+      ++text;
+    }
+  }
+
+  // A path needs somewhere to start, and every key but the last leads on
+  if (path.keyCount == 0)
+  {
+    return lineNumber + 1;
+  }
+
+  path.frameCount = 1;
+  for (int k = 0; k + 1 < path.keyCount; ++k)
+  {
+    path.frameCount += path.keys[k].frames;
+  }
+  return 0;
+}
+
+void ZoomPathFrame(const ZoomPath& path, int frame, PosterView& view)
+{
+  int k = 0;
+  while (k + 1 < path.keyCount && frame >= path.keys[k].frames)
+  {
+    frame -= path.keys[k].frames;
+    ++k;
+  }
+
+  const ZoomKey& from = path.keys[k];
+  const ZoomKey& to = path.keys[(k + 1 < path.keyCount) ? k + 1 : k];
+  const double t = (k + 1 < path.keyCount) ? static_cast<double>(frame) / from.frames : 0.0;
+
+  // Zooming at a steady rate means the spacing shrinks by the same factor
+  // every frame. Key frames get their spacing exactly
+  const double spacing = from.spacing * std::pow(to.spacing / from.spacing, t);
+
+  // The centre travels as far as the spacing has, so the target stays at the
+  // same place in the frame all through a zoom towards it. A path that pans
+  // at one zoom travels evenly. The weight is the share of the way still to
+  // go, measured from the next key, so deep in a zoom it shrinks with the
+  // spacing and keeps every bit. Measured from this key it would sit a hair
+  // under one, and the double would round the hair away
+  const double gap = from.spacing - to.spacing;
+  const double weight = (std::fabs(gap) > from.spacing * 1e-9) ? (spacing - to.spacing) / gap : 1.0 - t;
+  const BigFixed w = BigFixedFromDouble(weight);
+
+  view.centerRe = BigFixedAdd(to.centerRe, BigFixedMul(BigFixedAdd(from.centerRe, BigFixedNegate(to.centerRe)), w));
+  view.centerIm = BigFixedAdd(to.centerIm, BigFixedMul(BigFixedAdd(from.centerIm, BigFixedNegate(to.centerIm)), w));
+  view.spacing = spacing;
+  view.limit = static_cast<int>(std::lround(from.limit * std::pow(static_cast<double>(to.limit) / from.limit, t)));
+  view.width = path.width;
+  view.height = path.height;
+  view.palette = GetPalettePtr(static_cast<uint8_t>(from.palette));
+  view.cycle = 0;
+  view.cancel = nullptr;
+}
+
+bool ZoomPathRender(const PosterView& view, FieldCount* field)
+{
+  return PosterRenderRows(view, PosterNeedsDeep(view), 0, view.height, field);
+}
+
+bool ZoomPathBeginStream(ZoomPathWriter& writer, const ZoomPath& path, FILE* stream)
+{
+  writer.format = ZoomPathFormat::Y4m;
+  writer.stream = stream;
+  writer.pattern[0] = '\0';
+  writer.width = path.width;
+  writer.height = path.height;
+  writer.frames = 0;
+  writer.bytes = 0;
+  writer.planes = static_cast<uint8_t*>(malloc(3 * static_cast<size_t>(path.width) * path.height));
+
+  if (!writer.planes)
+  {
+    return false;
+  }
+
+  // Full chroma and the video range the palettes already hold, so no pixel
+  // needs converting or subsampling
+  char header[96];
+  const int length =
+    snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C444\n", path.width, path.height, path.rate);
+  if (!writeAll(writer, header, static_cast<size_t>(length)))
+  {
+    ZoomPathEnd(writer);
+    return false;
+  }
+  return true;
+}
+
+bool ZoomPathBeginImages(ZoomPathWriter& writer, const ZoomPath& path, const char* pattern, bool ppm)
+{
+  writer.format = ppm ? ZoomPathFormat::Ppm : ZoomPathFormat::Png;
+  writer.stream = nullptr;
+  writer.width = path.width;
+  writer.height = path.height;
+  writer.frames = 0;
+  writer.bytes = 0;
+  writer.planes = nullptr;
+
+  if (strlen(pattern) >= sizeof(writer.pattern))
+  {
+    return false;
+  }
+  strcpy(writer.pattern, pattern);
+  return true;
+}
+
+bool ZoomPathWriteFrame(ZoomPathWriter& writer, const PosterView& view, const FieldCount* field)
+{
+  const bool written = (writer.format == ZoomPathFormat::Y4m) ? writeStreamFrame(writer, view, field)
+                                                             : writeImageFrame(writer, view, field);
+  if (written)
+  {
+    ++writer.frames;
+  }
+  return written;
+}
+
+void ZoomPathEnd(ZoomPathWriter& writer)
+{
+  free(writer.planes);
+  writer.planes = nullptr;
+}
+
+// EOF
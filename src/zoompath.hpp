@@ -0,0 +1,122 @@
+// src/zoompath.hpp
+// SPDX-License-Identifier: GPL-3.0-or-later
+//
+// WMCPP (Wii Mandelbrot Computation Project Plus)
+// Copyright (C) 2025 DeltaResero
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+#ifndef ZOOMPATH_HPP
+#define ZOOMPATH_HPP
+
+// Renders a zoom animation from a list of keyframes. Between two keys the
+// spacing changes by the same factor every frame and the centre moves in step
+// with it, so the view glides onto the next key's centre as it reaches that
+// key's zoom. Frames go to a YUV4MPEG2 stream, which video tools read as it
+// is and which takes the palettes' YUV without conversion, or to numbered PNG
+// or PPM images. Like the poster renderer it needs nothing from libogc, and
+// the host tool in bench/ renders paths through the very same code
+
+#include "poster.hpp"
+
+#include <cstdint>
+#include <cstdio>
+
+static constexpr int ZOOM_PATH_KEYS = 64;
+
+struct ZoomKey
+{
+  BigFixed centerRe;
+  BigFixed centerIm;
+  double spacing;
+  int limit;
+  int palette;
+  // Frames from this key to the next. The last key's are not used
+  int frames;
+};
+
+struct ZoomPath
+{
+  int width;
+  int height;
+  int rate;
+  int keyCount;
+  int frameCount;
+  ZoomKey keys[ZOOM_PATH_KEYS];
+};
+
+/**
+ * Reads a path from text, one statement a line, with # starting a comment:
+ *
+ *   size WIDTH HEIGHT
+ *   rate FPS
+ *   key RE IM SPACING LIMIT PALETTE FRAMES
+ *
+ * RE and IM are exact decimals, as a poster's command line has them. Frames
+ * are 640x480 at 30 a second unless the path says otherwise, and the width
+ * has to be even
+ *
+ * @return 0 when the path is good, or the number of the first bad line
+ */
+int ZoomPathParse(const char* text, ZoomPath& path);
+
+// Fills in the view of a frame, counting from 0. Nothing will cancel it
+void ZoomPathFrame(const ZoomPath& path, int frame, PosterView& view);
+
+/**
+ * Renders the whole of a frame's view into field, by perturbation once the
+ * spacing needs it
+ *
+ * @return False when the view was cancelled or ran out of memory
+ */
+bool ZoomPathRender(const PosterView& view, FieldCount* field);
+
+enum class ZoomPathFormat
+{
+  Y4m,
+  Ppm,
+  Png
+};
+
+// Where frames go, and how much has gone there
+struct ZoomPathWriter
+{
+  ZoomPathFormat format;
+  FILE* stream;
+  // Image names, with one %d for the frame number
+  char pattern[256];
+  int width;
+  int height;
+  int frames;
+  uint64_t bytes;
+  // The three planes of a YUV4MPEG2 frame
+  uint8_t* planes;
+};
+
+/**
+ * Starts a YUV4MPEG2 stream of the path's frames on stream
+ *
+ * @return False when there was no memory for a frame or the header could not
+ * be written
+ */
+bool ZoomPathBeginStream(ZoomPathWriter& writer, const ZoomPath& path, FILE* stream);
+
+// Starts a sequence of PNG images, or PPM ones with ppm, named by pattern
+bool ZoomPathBeginImages(ZoomPathWriter& writer, const ZoomPath& path, const char* pattern, bool ppm);
+
+/**
+ * Colours the counts of the next frame, rendered from view, and writes them
+ *
+ * @return False when they could not be written
+ */
+bool ZoomPathWriteFrame(ZoomPathWriter& writer, const PosterView& view, const FieldCount* field);
+
+// Frees the writer's buffer. A stream is the caller's to close
+void ZoomPathEnd(ZoomPathWriter& writer);
+
+#endif // ZOOMPATH_HPP
+
+// EOF